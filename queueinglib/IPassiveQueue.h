@@ -11,9 +11,12 @@
 #define __QUEUEING_IPASSIVEQUEUE_H
 
 #include "QueueingDefs.h"
+#include <vector>
 
 namespace queueing {
 
+class Job;
+
 /**
  * The following interface must be implemented by a queue which can't process
  * jobs on its own. A server process uses these methods to query for new jobs
@@ -27,6 +30,10 @@ class QUEUEING_API IPassiveQueue
         virtual int length() = 0;
         // requests the queue to send out the next job on its "gateIndex" gate.
         virtual void request(int gateIndex) = 0;
+        // takes up to maxJobs jobs out of the queue for the server on its "gateIndex"
+        // gate, which must take() them, instead of sending them one at a time.
+        // Returns the number of jobs taken, 0 if not supported (added for swim)
+        virtual int requestBatch(int gateIndex, int maxJobs, std::vector<Job *>& jobs) { return 0; }
 };
 
 }; //namespace
@@ -108,5 +108,61 @@ void PassiveQueue::request(int gateIndex)
     send(job, "out", gateIndex);
 }
 
+int PassiveQueue::requestBatch(int gateIndex, int maxJobs, std::vector<Job *>& jobs)
+{
+    Enter_Method("requestBatch()!");
+
+    int taken = 0;
+    while (taken < maxJobs && !queue.isEmpty()) {
+        Job *job;
+        if (fifo) {
+            job = (Job *)queue.pop();
+        }
+        else {
+            job = (Job *)queue.back();
+            queue.remove(job);
+        }
+
+        job->setQueueCount(job->getQueueCount()+1);
+        simtime_t d = simTime() - job->getTimestamp();
+        job->setTotalQueueingTime(job->getTotalQueueingTime() + d);
+        emit(queueingTimeSignal, d);
+
+        drop(job);
+        jobs.push_back(job);
+        taken++;
+    }
+    if (taken > 0)
+        emit(queueLengthSignal, length());
+
+    return taken;
+}
+
+Job *PassiveQueue::dequeue()
+{
+    Enter_Method("dequeue()!");
+
+    ASSERT(!queue.isEmpty());
+
+    Job *job;
+    if (fifo) {
+        job = (Job *)queue.pop();
+    }
+    else {
+        job = (Job *)queue.back();
+        queue.remove(job);
+    }
+    emit(queueLengthSignal, length());
+
+    // the time spent here still counts as queueing time
+    job->setQueueCount(job->getQueueCount()+1);
+    simtime_t d = simTime() - job->getTimestamp();
+    job->setTotalQueueingTime(job->getTotalQueueingTime() + d);
+    emit(queueingTimeSignal, d);
+
+    drop(job);
+    return job;
+}
+
 }; //namespace
 
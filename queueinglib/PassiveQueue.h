@@ -17,6 +17,7 @@
 namespace queueing {
 
 class SelectionStrategy;
+class Job;
 
 /**
  * A passive queue, designed to co-operate with IServer using method calls.
@@ -47,6 +48,14 @@ class QUEUEING_API PassiveQueue : public cSimpleModule, public IPassiveQueue
         // The following methods are called from IServer:
         virtual int length() override;
         virtual void request(int gateIndex) override;
+        virtual int requestBatch(int gateIndex, int maxJobs, std::vector<Job *>& jobs) override;
+
+        /**
+         * Takes the next queued job out of the queue without serving it, so
+         * that it can be sent elsewhere. The caller must take() the job
+         * (added for swim, to migrate jobs from a server being removed)
+         */
+        virtual Job *dequeue();
 };
 
 }; //namespace
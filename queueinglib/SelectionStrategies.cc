@@ -49,10 +49,11 @@ SelectionStrategy *SelectionStrategy::create(const char *algName, cSimpleModule
 
 cGate *SelectionStrategy::selectableGate(int i)
 {
+    // follow the connection through compound modules (changed for swim, to share a queue among nested servers)
     if (isInputGate)
-        return hostModule->gate("in", i)->getPreviousGate();
+        return hostModule->gate("in", i)->getPathStartGate();
     else
-        return hostModule->gate("out", i)->getNextGate();
+        return hostModule->gate("out", i)->getPathEndGate();
 }
 
 bool SelectionStrategy::isSelectable(cModule *module)
@@ -65,6 +66,10 @@ bool SelectionStrategy::isSelectable(cModule *module)
     if (server != nullptr)
         return server->isIdle();
 
+    // the connection ends at a compound module, i.e., it has been disconnected (changed for swim)
+    if (!module->isSimple())
+        return false;
+
     throw cRuntimeError("Only IPassiveQueue and IServer is supported by this Strategy");
 }
 
@@ -0,0 +1,31 @@
+#!/bin/bash
+#
+# Runs SWIM against tools/hap_standin, which stands in for HAProxy and
+# LogFileProbe with a simulated server pool
+#
+MAINSIMDIR=../../src/
+MAINSIMEXEC=swim
+STANDIN=../../tools/hap_standin/hap_standin
+
+if [ $# -lt 1 ]; then
+	echo "usage: $0 config [run-number(s)|all [stand-in options]]"
+	echo example:
+	echo "  "$0 Reactive 0 -n 6 -r 40
+	exit 1
+fi
+
+CONFIG=$1
+RUNS=""
+if [ "$2" != "" ] && [ "$2" != "all" ]; then
+    RUNS="-r $2"
+fi
+shift
+[ $# -gt 0 ] && shift
+
+# the stand-in must have as many servers as maxServersPerType adds up to
+$STANDIN -a /tmp/haproxy.sock -n 6 "$@" &
+STANDINPID=$!
+trap 'kill $STANDINPID' EXIT
+sleep 1
+
+opp_runall -j1 $MAINSIMDIR/$MAINSIMEXEC swim_hap.ini -u Cmdenv -c $CONFIG -n ..:$MAINSIMDIR:../../../queueinglib:../../src -lqueueinglib $RUNS
@@ -14,8 +14,8 @@
  *******************************************************************************/
 #include "AdaptInterface.h"
 #include <string>
-#include <sstream>
-#include <boost/tokenizer.hpp>
+#include <cstdio>
+#include <cstdlib>
 #include <managers/execution/ExecutionManagerMod.h>
 #include "modules/LoadBalancer.h"
 Define_Module(AdaptInterface);
@@ -28,31 +28,62 @@ namespace {
     const string UNKNOWN_COMMAND = "error: unknown command\n";
     const string INVALID_ARGUMENT = "Invalid argument\n";
     const string COMMAND_SUCCESS = "OK\n";
+    const string LINE_TOO_LONG = "error: line too long\n";
+
+    /** a client that sends more than this without an end of line has its input discarded */
+    const size_t MAX_LINE_LENGTH = 64 * 1024;
+
+    /** seeds tried for a table size before trying a larger table */
+    const uint32_t MAX_HASH_SEEDS = 1000;
+
+    inline bool isSeparator(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
 }
 
 
-AdaptInterface::AdaptInterface() {
-    commandHandlers["add_server"] = std::bind(&AdaptInterface::cmdAddServer, this, std::placeholders::_1);
-    commandHandlers["remove_server"] = std::bind(&AdaptInterface::cmdRemoveServer, this, std::placeholders::_1);
-    commandHandlers["set_dimmer"] = std::bind(&AdaptInterface::cmdSetDimmer, this, std::placeholders::_1);
-    commandHandlers["divert_traffic"] = std::bind(&AdaptInterface::cmdDivertTraffic, this, std::placeholders::_1);
-    commandHandlers["inc_dimmer"] = std::bind(&AdaptInterface::cmdIncreaseDimmer, this, std::placeholders::_1);
-    commandHandlers["dec_dimmer"] = std::bind(&AdaptInterface::cmdDecreaseDimmer, this, std::placeholders::_1);
+AdaptInterface::AdaptInterface() : commandHashSeed(0) {
+    registerCommand("add_server", std::bind(&AdaptInterface::cmdAddServer, this, std::placeholders::_1));
+    registerCommand("remove_server", std::bind(&AdaptInterface::cmdRemoveServer, this, std::placeholders::_1));
+    registerCommand("suspend_server", std::bind(&AdaptInterface::cmdSuspendServer, this, std::placeholders::_1));
+    registerCommand("resume_server", std::bind(&AdaptInterface::cmdResumeServer, this, std::placeholders::_1));
+    registerCommand("set_dimmer", std::bind(&AdaptInterface::cmdSetDimmer, this, std::placeholders::_1));
+    registerCommand("divert_traffic", std::bind(&AdaptInterface::cmdDivertTraffic, this, std::placeholders::_1));
+    registerCommand("inc_dimmer", std::bind(&AdaptInterface::cmdIncreaseDimmer, this, std::placeholders::_1));
+    registerCommand("dec_dimmer", std::bind(&AdaptInterface::cmdDecreaseDimmer, this, std::placeholders::_1));
 
 
     // get commands
-    commandHandlers["get_dimmer"] = std::bind(&AdaptInterface::cmdGetDimmer, this, std::placeholders::_1);
-    commandHandlers["get_servers"] = std::bind(&AdaptInterface::cmdGetServers, this, std::placeholders::_1);
-    commandHandlers["get_active_servers"] = std::bind(&AdaptInterface::cmdGetActiveServers, this, std::placeholders::_1);
-    commandHandlers["get_max_servers"] = std::bind(&AdaptInterface::cmdGetMaxServers, this, std::placeholders::_1);
-    commandHandlers["get_utilization"] = std::bind(&AdaptInterface::cmdGetUtilization, this, std::placeholders::_1);
-    commandHandlers["get_avg_rt"] = std::bind(&AdaptInterface::cmdGetAvgResponseTime, this, std::placeholders::_1);
-    commandHandlers["get_basic_rt"] = std::bind(&AdaptInterface::cmdGetBasicResponseTime, this, std::placeholders::_1);
-    commandHandlers["get_basic_throughput"] = std::bind(&AdaptInterface::cmdGetBasicThroughput, this, std::placeholders::_1);
-    commandHandlers["get_opt_rt"] = std::bind(&AdaptInterface::cmdGetOptResponseTime, this, std::placeholders::_1);
-    commandHandlers["get_opt_throughput"] = std::bind(&AdaptInterface::cmdGetOptThroughput, this, std::placeholders::_1);
-    commandHandlers["get_arrival_rate"] = std::bind(&AdaptInterface::cmdGetArrivalRate, this, std::placeholders::_1);
-    commandHandlers["get_traffic"] = std::bind(&AdaptInterface::cmdGetTraffic, this, std::placeholders::_1);
+    registerCommand("get_dimmer", std::bind(&AdaptInterface::cmdGetDimmer, this, std::placeholders::_1));
+    registerCommand("get_servers", std::bind(&AdaptInterface::cmdGetServers, this, std::placeholders::_1));
+    registerCommand("get_active_servers", std::bind(&AdaptInterface::cmdGetActiveServers, this, std::placeholders::_1));
+    registerCommand("get_max_servers", std::bind(&AdaptInterface::cmdGetMaxServers, this, std::placeholders::_1));
+    registerCommand("get_suspended_servers", std::bind(&AdaptInterface::cmdGetSuspendedServers, this, std::placeholders::_1));
+    registerCommand("get_server_types", std::bind(&AdaptInterface::cmdGetServerTypes, this, std::placeholders::_1));
+    registerCommand("get_utilization", std::bind(&AdaptInterface::cmdGetUtilization, this, std::placeholders::_1));
+    registerCommand("get_avg_rt", std::bind(&AdaptInterface::cmdGetAvgResponseTime, this, std::placeholders::_1));
+    registerCommand("get_basic_rt", std::bind(&AdaptInterface::cmdGetBasicResponseTime, this, std::placeholders::_1));
+    registerCommand("get_basic_throughput", std::bind(&AdaptInterface::cmdGetBasicThroughput, this, std::placeholders::_1));
+    registerCommand("get_opt_rt", std::bind(&AdaptInterface::cmdGetOptResponseTime, this, std::placeholders::_1));
+    registerCommand("get_opt_throughput", std::bind(&AdaptInterface::cmdGetOptThroughput, this, std::placeholders::_1));
+    registerCommand("get_arrival_rate", std::bind(&AdaptInterface::cmdGetArrivalRate, this, std::placeholders::_1));
+    registerCommand("get_traffic", std::bind(&AdaptInterface::cmdGetTraffic, this, std::placeholders::_1));
+    registerCommand("get_queue_length", std::bind(&AdaptInterface::cmdGetQueueLength, this, std::placeholders::_1));
+    registerCommand("get_queueing_delay", std::bind(&AdaptInterface::cmdGetQueueingDelay, this, std::placeholders::_1));
+    registerCommand("get_rt_p50", std::bind(&AdaptInterface::cmdGetResponseTimePercentile, this, 50.0, std::placeholders::_1));
+    registerCommand("get_rt_p95", std::bind(&AdaptInterface::cmdGetResponseTimePercentile, this, 95.0, std::placeholders::_1));
+    registerCommand("get_rt_p99", std::bind(&AdaptInterface::cmdGetResponseTimePercentile, this, 99.0, std::placeholders::_1));
+
+    // per server type and per server observations
+    registerCommand("get_type_rt", std::bind(&AdaptInterface::cmdGetServerTypeObservation, this, &ServerObservations::responseTime, std::placeholders::_1));
+    registerCommand("get_type_throughput", std::bind(&AdaptInterface::cmdGetServerTypeObservation, this, &ServerObservations::throughput, std::placeholders::_1));
+    registerCommand("get_type_utilization", std::bind(&AdaptInterface::cmdGetServerTypeObservation, this, &ServerObservations::utilization, std::placeholders::_1));
+    registerCommand("get_type_queue_length", std::bind(&AdaptInterface::cmdGetServerTypeObservation, this, &ServerObservations::queueLength, std::placeholders::_1));
+    registerCommand("get_type_queueing_delay", std::bind(&AdaptInterface::cmdGetServerTypeObservation, this, &ServerObservations::queueingDelay, std::placeholders::_1));
+    registerCommand("get_server_rt", std::bind(&AdaptInterface::cmdGetServerObservation, this, &ServerObservations::responseTime, std::placeholders::_1));
+    registerCommand("get_server_throughput", std::bind(&AdaptInterface::cmdGetServerObservation, this, &ServerObservations::throughput, std::placeholders::_1));
+    registerCommand("get_server_queue_length", std::bind(&AdaptInterface::cmdGetServerObservation, this, &ServerObservations::queueLength, std::placeholders::_1));
+    registerCommand("get_server_queueing_delay", std::bind(&AdaptInterface::cmdGetServerObservation, this, &ServerObservations::queueingDelay, std::placeholders::_1));
  
     // dimmer, numServers, numActiveServers, utilization(total or indiv), response time and throughput for mandatory and optional, avg arrival rate
 }
@@ -63,9 +94,11 @@ AdaptInterface::~AdaptInterface() {
 
 void AdaptInterface::initialize()
 {
+    buildCommandTable();
+
     rtEvent = new cMessage("rtEvent");
-    rtScheduler = check_and_cast<cSocketRTScheduler *>(getSimulation()->getScheduler());
-    rtScheduler->setInterfaceModule(this, rtEvent, recvBuffer, BUFFER_SIZE, &numRecvBytes);
+    rtScheduler = check_and_cast<MultiClientRTScheduler *>(getSimulation()->getScheduler());
+    rtScheduler->setInterfaceModule(this, rtEvent);
     pModel = check_and_cast<Model*> (getParentModule()->getSubmodule("model"));
     pProbe = check_and_cast<IProbe*> (gate("probe")->getPreviousGate()->getOwnerModule());
 }
@@ -74,189 +107,394 @@ void AdaptInterface::handleMessage(cMessage *msg)
 {
     if (msg == rtEvent) {
 
-        // get data from buffer
-        string input = string(recvBuffer, numRecvBytes);
-        numRecvBytes = 0;
+        // each client has its own buffer, and gets the replies to its commands
+        rtScheduler->takeReadyClients(readyClients);
+        for (int clientId : readyClients) {
+            string* input = rtScheduler->getReceiveBuffer(clientId);
+            if (input) {
+                processInput(clientId, *input);
+            }
+        }
+    }
+}
+
+void AdaptInterface::registerCommand(const std::string& name, CommandHandler handler) {
+    ASSERT(commandTable.empty()); // the table points to the commands
+    for (Command& command : commands) {
+        if (command.name == name) {
+            command.handler = handler;
+            return;
+        }
+    }
+    Command command;
+    command.name = name;
+    command.handler = handler;
+    commands.push_back(command);
+}
+
+uint32_t AdaptInterface::hashCommand(const char* name, size_t length, uint32_t seed) {
+
+    // FNV-1a, followed by the MurmurHash3 finalizer so that the low bits depend on all the others
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) name[i];
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+void AdaptInterface::buildCommandTable() {
+
+    // with 4 slots per command, a seed without collisions is found after a few tries
+    size_t size = 1;
+    while (size < 4 * commands.size()) {
+        size *= 2;
+    }
+
+    while (true) {
+        for (uint32_t seed = 0; seed < MAX_HASH_SEEDS; seed++) {
+            commandTable.assign(size, nullptr);
+            bool collision = false;
+            for (const Command& command : commands) {
+                const Command*& slot = commandTable[hashCommand(command.name.data(), command.name.length(), seed) & (size - 1)];
+                if (slot) {
+                    collision = true;
+                    break;
+                }
+                slot = &command;
+            }
+            if (!collision) {
+                commandHashSeed = seed;
+                return;
+            }
+        }
+        size *= 2;
+    }
+}
+
+const AdaptInterface::Command* AdaptInterface::findCommand(const CommandToken& name) const {
+    const Command* command = commandTable[hashCommand(name.data, name.length, commandHashSeed) & (commandTable.size() - 1)];
+    if (command && command->name.length() == name.length
+            && memcmp(command->name.data(), name.data, name.length) == 0) {
+        return command;
+    }
+    return nullptr;
+}
+
+void AdaptInterface::processInput(int clientId, std::string& input) {
 #if DEBUG_ADAPT_INTERFACE
-        EV << "received [" << input << "]" << endl;
+    EV << "received [" << input << "] from client " << clientId << endl;
 #endif
-        std::istringstream inputStream(input);
+    reply.clear();
+
+    // the lines are parsed in place, and only the complete ones are consumed
+    char* begin = &input[0];
+    char* end = begin + input.length();
+    char* line = begin;
+    char* lineEnd;
+    while ((lineEnd = static_cast<char*>(memchr(line, '\n', end - line))) != nullptr) {
+        executeLine(line, lineEnd);
+        line = lineEnd + 1;
+    }
+    input.erase(0, line - begin);
 
-        std::string line;
-        while (std::getline(inputStream, line))
-        {
-            line.erase(line.find_last_not_of("\r\n") + 1);
+    if (input.length() > MAX_LINE_LENGTH) {
+        input.clear();
+        reply += LINE_TOO_LONG;
+    }
+
+    if (!reply.empty()) {
+        rtScheduler->sendBytes(clientId, reply.data(), reply.length());
+    }
+}
+
+void AdaptInterface::executeLine(char* line, char* end) {
+    *end = '\0';
 #if DEBUG_ADAPT_INTERFACE
-            cout << "received line is [" << line << "]" << endl;
+    cout << "received line is [" << line << "]" << endl;
 #endif
-            typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
-            tokenizer tokens(line, boost::char_separator<char>(" "));
-            tokenizer::iterator it = tokens.begin();
-            if (it != tokens.end()) {
-                string command = *it;
-                vector<string> args;
-                while (++it != tokens.end()) {
-                    args.push_back(*it);
-                }
 
-                auto handler = commandHandlers.find(command);
-                if (handler == commandHandlers.end()) {
-                    rtScheduler->sendBytes(UNKNOWN_COMMAND.c_str(), UNKNOWN_COMMAND.length());
-                } else {
-                    string reply = commandHandlers[command](args);
+    // each token is ended with '\0' where its separator was
+    args.clear();
+    char* current = line;
+    while (current < end) {
+        while (current < end && isSeparator(*current)) {
+            current++;
+        }
+        if (current == end) {
+            break;
+        }
+        CommandToken token;
+        token.data = current;
+        while (current < end && !isSeparator(*current)) {
+            current++;
+        }
+        token.length = current - token.data;
+        *current++ = '\0';
+        args.push_back(token);
+    }
+    if (args.empty()) {
+        return;
+    }
+
+    CommandToken name = args.front();
+    args.erase(args.begin());
+
+    const Command* command = findCommand(name);
+    if (!command) {
+        reply += UNKNOWN_COMMAND;
+    } else {
 #if DEBUG_ADAPT_INTERFACE
-                    cout << "command reply is[" << reply << ']' << endl;
+        size_t replyStart = reply.length();
 #endif
-                    rtScheduler->sendBytes(reply.c_str(), reply.length());
-                }
-            }
+        command->handler(args);
+#if DEBUG_ADAPT_INTERFACE
+        cout << "command reply is[" << reply.substr(replyStart) << ']' << endl;
+#endif
+    }
+}
+
+void AdaptInterface::appendReply(double value) {
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%g\n", value); // same as the default of ostream
+    reply.append(buffer, length);
+}
 
+void AdaptInterface::appendReply(int value) {
+    char buffer[16];
+    int length = snprintf(buffer, sizeof(buffer), "%d\n", value);
+    reply.append(buffer, length);
+}
+
+void AdaptInterface::cmdGetAvgResponseTime(const CommandArgs& args) {
+    appendReply(pModel->getAvgResponseTime());
+}
+
+MTServerType::ServerType AdaptInterface::getServerTypeArg(const CommandToken& arg) const {
+    MTServerType::ServerType serverType = pModel->getServerType(arg.str());
+    if (serverType == MTServerType::NONE) {
+        int type = atoi(arg.c_str());
+        if (type > MTServerType::NONE && type <= (int) pModel->getNumberOfServerTypes()) {
+            serverType = MTServerType::ServerType(type);
         }
+    }
+    return serverType;
+}
 
+int AdaptInterface::getCountArg(const CommandArgs& args, unsigned index) const {
+    if (args.size() <= index) {
+        return 1;
     }
+    int count = atoi(args[index].c_str());
+    return (count < 1) ? 0 : count;
 }
 
-std::string AdaptInterface::cmdGetAvgResponseTime(
-        const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pModel->getAvgResponseTime() << '\n';
+bool AdaptInterface::canRemoveServers(MTServerType::ServerType serverType, int count) const {
 
-    return reply.str();
+    // servers being drained are already on their way out, and one active server must be left
+    Configuration configuration = pModel->getConfiguration();
+    return configuration.getServers(serverType) - pModel->getDrainingServers(serverType) >= count
+            && configuration.getTotalActiveServers() - pModel->getTotalDrainingServers() > count;
 }
 
-std::string AdaptInterface::cmdAddServer(const std::vector<std::string>& args) {
-    MTServerType::ServerType serverType = MTServerType::ServerType(atoi(args[0].c_str()));
+void AdaptInterface::cmdAddServer(const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing server type argument\n";
+        return;
+    }
+
+    // optional number of servers, which are booted concurrently
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    int count = getCountArg(args, 1);
+    if (serverType == MTServerType::NONE || count == 0
+            || pModel->getConfiguration().getServers(serverType) + count > pModel->getMaxServers(serverType)) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
     ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
-    pExecMgr->addServer(serverType);
+    pExecMgr->addServers(serverType, count);
 
-    return COMMAND_SUCCESS;
+    reply += COMMAND_SUCCESS;
 }
 
-std::string AdaptInterface::cmdRemoveServer(const std::vector<std::string>& args) {
-    MTServerType::ServerType serverType = MTServerType::ServerType(atoi(args[0].c_str()));
+void AdaptInterface::cmdRemoveServer(const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing server type argument\n";
+        return;
+    }
+
     ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
-    pExecMgr->removeServer(serverType);
 
-    return COMMAND_SUCCESS;
+    // a server can also be removed by name (e.g., server_A_2), instead of the one added last
+    cModule* server = getParentModule()->getSubmodule(args[0].c_str());
+    if (server) {
+        MTServerType::ServerType serverType = pExecMgr->getServerType(server);
+        if (args.size() > 1 || !pExecMgr->hasServer(serverType, server->getId())
+                || !canRemoveServers(serverType, 1)) {
+            reply += INVALID_ARGUMENT;
+            return;
+        }
+        pExecMgr->removeServer(serverType, server->getId());
+        reply += COMMAND_SUCCESS;
+        return;
+    }
+
+    // optional number of servers, which are drained concurrently
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    int count = getCountArg(args, 1);
+    if (serverType == MTServerType::NONE || count == 0 || !canRemoveServers(serverType, count)) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    pExecMgr->removeServers(serverType, count);
+
+    reply += COMMAND_SUCCESS;
+}
+
+void AdaptInterface::cmdSuspendServer(const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing server type argument\n";
+        return;
+    }
+
+    // optional number of servers, which are drained concurrently
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    int count = getCountArg(args, 1);
+    if (serverType == MTServerType::NONE || count == 0) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    // only active servers that are not being removed can be suspended
+    Configuration configuration = pModel->getConfiguration();
+    if (configuration.getActiveServers(serverType) - pModel->getDrainingServers(serverType) < count
+            || configuration.getTotalActiveServers() - pModel->getTotalDrainingServers() <= count) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
+    pExecMgr->suspendServers(serverType, count);
+
+    reply += COMMAND_SUCCESS;
 }
 
-std::string AdaptInterface::cmdGetTraffic(const std::vector<std::string>& args) {
+void AdaptInterface::cmdResumeServer(const CommandArgs& args) {
     if (args.size() == 0) {
-        return "error: missing get_traffic argument\n";
+        reply += "error: missing server type argument\n";
+        return;
     }
 
-    MTServerType::ServerType serverType = MTServerType::ServerType(atoi(args[0].c_str()));
+    // optional number of servers, which are resumed concurrently
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    int count = getCountArg(args, 1);
+    if (serverType == MTServerType::NONE || count == 0) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    if (pModel->getSuspendedServers(serverType) < count
+            || pModel->getConfiguration().getServers(serverType) + count > pModel->getMaxServers(serverType)) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
 
-    ostringstream reply;
-    reply << pModel->getConfiguration().getTraffic(serverType) << '\n';
+    ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
+    pExecMgr->resumeServers(serverType, count);
 
-    return reply.str();
+    reply += COMMAND_SUCCESS;
 }
 
-std::string AdaptInterface::cmdSetDimmer(const std::vector<std::string>& args) {
+void AdaptInterface::cmdGetTraffic(const CommandArgs& args) {
     if (args.size() == 0) {
-        return "error: missing dimmer argument\n";
+        reply += "error: missing get_traffic argument\n";
+        return;
+    }
+
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    if (serverType == MTServerType::NONE) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    appendReply((int) pModel->getConfiguration().getTraffic(serverType));
+}
+
+void AdaptInterface::cmdSetDimmer(const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing dimmer argument\n";
+        return;
     }
 
     double dimmer = atof(args[0].c_str());
     ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
     pExecMgr->setBrownout(1 - dimmer);
 
-    return COMMAND_SUCCESS;
+    reply += COMMAND_SUCCESS;
 }
 
 
-std::string AdaptInterface::cmdGetDimmer(const std::vector<std::string>& args) {
-    ostringstream reply;
+void AdaptInterface::cmdGetDimmer(const CommandArgs& args) {
     double brownoutFactor = pModel->getBrownoutFactor();
     double dimmer = (1 - brownoutFactor);
 
-    reply << dimmer << '\n';
-
-    return reply.str();
+    appendReply(dimmer);
 }
 
-std::string AdaptInterface::cmdDivertTraffic(const std::vector<std::string>& args) {
+void AdaptInterface::cmdDivertTraffic(const CommandArgs& args) {
     if (args.size() == 0) {
-        return "error: missing divert_traffic argument\n";
-    }
-
-    string divertCmdString = args[0];
-    LoadBalancer::TrafficLoad serverA = LoadBalancer::INVALID;
-    LoadBalancer::TrafficLoad serverB = LoadBalancer::INVALID;
-    LoadBalancer::TrafficLoad serverC = LoadBalancer::INVALID;
-
-    if (divertCmdString == "divert_100_0_0") {
-        serverA = LoadBalancer::TrafficLoad::HUNDRED;
-        serverB = LoadBalancer::TrafficLoad::ZERO;
-        serverC = LoadBalancer::TrafficLoad::ZERO;
-    } else if (divertCmdString == "divert_75_25_0") {
-        serverA = LoadBalancer::TrafficLoad::SEVENTYFIVE;
-        serverB = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverC = LoadBalancer::TrafficLoad::ZERO;
-    } else if (divertCmdString == "divert_75_0_25") {
-        serverA = LoadBalancer::TrafficLoad::SEVENTYFIVE;
-        serverB = LoadBalancer::TrafficLoad::ZERO;
-        serverC = LoadBalancer::TrafficLoad::TWENTYFIVE;
-    } else if (divertCmdString == "divert_50_50_0") {
-        serverA = LoadBalancer::TrafficLoad::FIFTY;
-        serverB = LoadBalancer::TrafficLoad::FIFTY;
-        serverC = LoadBalancer::TrafficLoad::ZERO;
-    } else if (divertCmdString == "divert_50_0_50") {
-        serverA = LoadBalancer::TrafficLoad::FIFTY;
-        serverB = LoadBalancer::TrafficLoad::ZERO;
-        serverC = LoadBalancer::TrafficLoad::FIFTY;
-    } else if (divertCmdString == "divert_50_25_25") {
-        serverA = LoadBalancer::TrafficLoad::FIFTY;
-        serverB = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverC = LoadBalancer::TrafficLoad::TWENTYFIVE;
-    } else if (divertCmdString == "divert_25_75_0") {
-        serverA = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverB = LoadBalancer::TrafficLoad::SEVENTYFIVE;
-        serverC = LoadBalancer::TrafficLoad::ZERO;
-    } else if (divertCmdString == "divert_25_0_75") {
-        serverA = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverB = LoadBalancer::TrafficLoad::ZERO;
-        serverC = LoadBalancer::TrafficLoad::SEVENTYFIVE;;
-    } else if (divertCmdString == "divert_25_50_25") {
-        serverA = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverB = LoadBalancer::TrafficLoad::FIFTY;
-        serverC = LoadBalancer::TrafficLoad::TWENTYFIVE;
-    } else if (divertCmdString == "divert_25_25_50") {
-        serverA = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverB = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverC = LoadBalancer::TrafficLoad::FIFTY;
-    } else if (divertCmdString == "divert_0_100_0") {
-        serverA = LoadBalancer::TrafficLoad::ZERO;
-        serverB = LoadBalancer::TrafficLoad::HUNDRED;
-        serverC = LoadBalancer::TrafficLoad::ZERO;
-    } else if (divertCmdString == "divert_0_0_100") {
-        serverA = LoadBalancer::TrafficLoad::ZERO;
-        serverB = LoadBalancer::TrafficLoad::ZERO;
-        serverC = LoadBalancer::TrafficLoad::HUNDRED;
-    } else if (divertCmdString == "divert_0_75_25") {
-        serverA = LoadBalancer::TrafficLoad::ZERO;
-        serverB = LoadBalancer::TrafficLoad::SEVENTYFIVE;
-        serverC = LoadBalancer::TrafficLoad::TWENTYFIVE;
-    } else if (divertCmdString == "divert_0_25_75") {
-        serverA = LoadBalancer::TrafficLoad::ZERO;
-        serverB = LoadBalancer::TrafficLoad::TWENTYFIVE;
-        serverC = LoadBalancer::TrafficLoad::SEVENTYFIVE;
-    } else if (divertCmdString == "divert_0_50_50") {
-        serverA = LoadBalancer::TrafficLoad::ZERO;
-        serverB = LoadBalancer::TrafficLoad::FIFTY;
-        serverC = LoadBalancer::TrafficLoad::FIFTY;
-    } else {
-        return INVALID_ARGUMENT;
+        reply += "error: missing divert_traffic argument\n";
+        return;
+    }
+
+    /*
+     * the argument is divert_<p1>_<p2>_..._<pN>, with the percentage of
+     * the traffic for each server type in type id order. Percentages must
+     * be multiples of 25 and add up to 100
+     */
+    static const char prefix[] = "divert_";
+    const size_t prefixLength = sizeof(prefix) - 1;
+    if (args[0].length < prefixLength || memcmp(args[0].data, prefix, prefixLength) != 0) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    std::vector<LoadBalancer::TrafficLoad> traffic(1, LoadBalancer::INVALID); // NONE has no traffic
+    int total = 0;
+    const char* percentage = args[0].c_str() + prefixLength;
+    while (true) {
+        char* end;
+        long value = strtol(percentage, &end, 10);
+        if (end == percentage || (*end != '\0' && *end != '_') || value < 0 || value > 100 || value % 25 != 0) {
+            reply += INVALID_ARGUMENT;
+            return;
+        }
+        traffic.push_back(LoadBalancer::TrafficLoad(LoadBalancer::ZERO + value / 25));
+        total += value;
+        if (*end == '\0') {
+            break;
+        }
+        percentage = end + 1;
+    }
+    if (traffic.size() != pModel->getNumberOfServerTypes() + 1 || total != 100) {
+        reply += INVALID_ARGUMENT;
+        return;
     }
 
     ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
-    pExecMgr->divertTraffic(serverA, serverB, serverC);
+    pExecMgr->divertTraffic(traffic);
 
-    return COMMAND_SUCCESS;
+    reply += COMMAND_SUCCESS;
 }
 
-std::string AdaptInterface::setDimmer(int dimmerLevel) {
+void AdaptInterface::setDimmer(int dimmerLevel) {
     double newBrownoutFactor = 0.0;
 
     newBrownoutFactor = (dimmerLevel - 1.0)
@@ -265,128 +503,175 @@ std::string AdaptInterface::setDimmer(int dimmerLevel) {
     ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
     pExecMgr->setBrownout(newBrownoutFactor);
 
-    return COMMAND_SUCCESS;
+    reply += COMMAND_SUCCESS;
 }
 
-std::string AdaptInterface::cmdDecreaseDimmer(const std::vector<std::string>& args) {
+void AdaptInterface::cmdDecreaseDimmer(const CommandArgs& args) {
     int dimmerLevel = pModel->getDimmerLevel();
     dimmerLevel++; 
-    return setDimmer(dimmerLevel);
+    setDimmer(dimmerLevel);
 }
 
-std::string AdaptInterface::cmdIncreaseDimmer(const std::vector<std::string>& args) {
+void AdaptInterface::cmdIncreaseDimmer(const CommandArgs& args) {
     int dimmerLevel = pModel->getDimmerLevel();
     dimmerLevel--; 
-    return setDimmer(dimmerLevel);
+    setDimmer(dimmerLevel);
 }
 
 
-std::string AdaptInterface::cmdGetServers(const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pModel->getServers() << '\n';
-
-    return reply.str();
+void AdaptInterface::cmdGetServers(const CommandArgs& args) {
+    appendReply(pModel->getServers());
 }
 
 
-std::string AdaptInterface::cmdGetActiveServers(const std::vector<std::string>& args) {
-    if (args.size() == 0) {return "error: missing get_max_servers argument\n";}
-    ostringstream reply;
-    int maxServer = 0;
-    MTServerType::ServerType serverType = MTServerType::ServerType(atoi(args[0].c_str()));
-
-    if (serverType == MTServerType::POWERFUL) {
-        maxServer = omnetpp::getSimulation()->getSystemModule()->par("maxServersA");
-    } else if (serverType == MTServerType::AVERAGE) {
-        maxServer = omnetpp::getSimulation()->getSystemModule()->par("maxServersB");
-    } else if (serverType == MTServerType::WEAK) {
-        maxServer = omnetpp::getSimulation()->getSystemModule()->par("maxServersC");
-    } else {
-        return INVALID_ARGUMENT;
+void AdaptInterface::cmdGetActiveServers(const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing get_active_servers argument\n";
+        return;
     }
-    reply << maxServer << '\n';
-
-    return reply.str();
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    if (serverType == MTServerType::NONE) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+    appendReply(pModel->getConfiguration().getActiveServers(serverType));
 }
 
 
-std::string AdaptInterface::cmdGetMaxServers(const std::vector<std::string>& args) {
-    ostringstream reply;
+void AdaptInterface::cmdGetMaxServers(const CommandArgs& args) {
     if (args.size() == 0) {
-        return "error: missing get_max_servers argument\n";
+        reply += "error: missing get_max_servers argument\n";
+        return;
     }
 
-    int maxServer = 0;
-    MTServerType::ServerType serverType = MTServerType::ServerType(atoi(args[0].c_str()));
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    if (serverType == MTServerType::NONE) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+    appendReply(pModel->getMaxServers(serverType));
+}
 
-    if (serverType == MTServerType::POWERFUL) {
-        maxServer = omnetpp::getSimulation()->getSystemModule()->par("maxServersA");
-    } else if (serverType == MTServerType::AVERAGE) {
-        maxServer = omnetpp::getSimulation()->getSystemModule()->par("maxServersB");
-    } else if (serverType == MTServerType::WEAK) {
-        maxServer = omnetpp::getSimulation()->getSystemModule()->par("maxServersC");
-    } else {
-        return INVALID_ARGUMENT;
+void AdaptInterface::cmdGetSuspendedServers(const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing get_suspended_servers argument\n";
+        return;
     }
-    reply << maxServer << '\n';
 
-    return reply.str();
+    MTServerType::ServerType serverType = getServerTypeArg(args[0]);
+    if (serverType == MTServerType::NONE) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+    appendReply(pModel->getSuspendedServers(serverType));
 }
 
 
-std::string AdaptInterface::cmdGetUtilization(const std::vector<std::string>& args) {
+void AdaptInterface::cmdGetServerTypes(const CommandArgs& args) {
+    for (unsigned type = MTServerType::NONE + 1; type <= pModel->getNumberOfServerTypes(); type++) {
+        if (type > MTServerType::NONE + 1) {
+            reply += ' ';
+        }
+        reply += pModel->getServerTypeName(MTServerType::ServerType(type));
+    }
+    reply += '\n';
+}
+
+
+void AdaptInterface::cmdGetUtilization(const CommandArgs& args) {
     if (args.size() == 0) {
-        return "error: missing server argument\n";
+        reply += "error: missing server argument\n";
+        return;
     }
 
-    ostringstream reply;
-    auto utilization = pProbe->getUtilization(args[0]);
+    auto utilization = pProbe->getUtilization(args[0].str());
     if (utilization < 0) {
-        reply << "error: server \'" << args[0] << "\' does no exist";
+        reply += "error: server \'";
+        reply.append(args[0].data, args[0].length);
+        reply += "\' does no exist\n";
     } else {
-        reply << utilization;
+        appendReply(utilization);
     }
-    reply << '\n';
+}
 
-    return reply.str();
+void AdaptInterface::cmdGetBasicResponseTime(const CommandArgs& args) {
+    appendReply(pProbe->getBasicResponseTime());
 }
 
-std::string AdaptInterface::cmdGetBasicResponseTime(
-        const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pProbe->getBasicResponseTime() << '\n';
+void AdaptInterface::cmdGetBasicThroughput(const CommandArgs& args) {
+    appendReply(pProbe->getBasicThroughput());
+}
 
-    return reply.str();
+void AdaptInterface::cmdGetOptResponseTime(const CommandArgs& args) {
+    appendReply(pProbe->getOptResponseTime());
 }
 
-std::string AdaptInterface::cmdGetBasicThroughput(
-        const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pProbe->getBasicThroughput() << '\n';
+void AdaptInterface::cmdGetOptThroughput(const CommandArgs& args) {
+    appendReply(pProbe->getOptThroughput());
+}
 
-    return reply.str();
+void AdaptInterface::cmdGetArrivalRate(const CommandArgs& args) {
+    appendReply(pProbe->getArrivalRate());
 }
 
-std::string AdaptInterface::cmdGetOptResponseTime(
-        const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pProbe->getOptResponseTime() << '\n';
+void AdaptInterface::cmdGetQueueLength(const CommandArgs& args) {
+    appendReply(pProbe->getQueueLength());
+}
 
-    return reply.str();
+void AdaptInterface::cmdGetQueueingDelay(const CommandArgs& args) {
+    appendReply(pProbe->getQueueingDelay());
 }
 
-std::string AdaptInterface::cmdGetOptThroughput(
-        const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pProbe->getOptThroughput() << '\n';
+void AdaptInterface::cmdGetResponseTimePercentile(double percentile,
+        const CommandArgs& args) {
+    double value;
+    if (args.size() == 0) {
+        value = pProbe->getResponseTimePercentile(percentile);
+    } else if (args[0] == "basic") {
+        value = pProbe->getBasicResponseTimePercentile(percentile);
+    } else if (args[0] == "opt") {
+        value = pProbe->getOptResponseTimePercentile(percentile);
+    } else {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
 
-    return reply.str();
+    if (value < 0) {
+        reply += "error: response time percentile not available\n";
+    } else {
+        appendReply(value);
+    }
 }
 
-std::string AdaptInterface::cmdGetArrivalRate(
-        const std::vector<std::string>& args) {
-    ostringstream reply;
-    reply << pProbe->getArrivalRate() << '\n';
+void AdaptInterface::cmdGetServerTypeObservation(double ServerObservations::* observation,
+        const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing server type argument\n";
+        return;
+    }
 
-    return reply.str();
+    ServerObservations serverType = pProbe->getServerTypeObservations(getServerTypeArg(args[0]));
+    if (serverType.utilization < 0) {
+        reply += INVALID_ARGUMENT;
+        return;
+    }
+
+    appendReply(serverType.*observation);
+}
+
+void AdaptInterface::cmdGetServerObservation(double ServerObservations::* observation,
+        const CommandArgs& args) {
+    if (args.size() == 0) {
+        reply += "error: missing server argument\n";
+        return;
+    }
+
+    ServerObservations server = pProbe->getServerObservations(args[0].str());
+    if (server.utilization < 0) {
+        reply += "error: server \'";
+        reply.append(args[0].data, args[0].length);
+        reply += "\' does no exist\n";
+    } else {
+        appendReply(server.*observation);
+    }
 }
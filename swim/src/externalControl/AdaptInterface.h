@@ -15,61 +15,188 @@
 #ifndef __SWIM_ADAPTINTERFACE_H_
 #define __SWIM_ADAPTINTERFACE_H_
 
-#include "SocketRTScheduler.h"
+#include "MultiClientRTScheduler.h"
 #include <omnetpp.h>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
-#include <stack>
 #include <functional>
-#include <map>
 #include "model/Model.h"
 #include "managers/monitor/IProbe.h"
 
+/**
+ * Token of a command line, kept in place in the receive buffer
+ *
+ * C++11 has no std::string_view. The parser ends each token with '\0',
+ * so the token can also be used as a C string
+ */
+struct CommandToken {
+    const char* data;
+    size_t length;
+
+    const char* c_str() const { return data; }
+    std::string str() const { return std::string(data, length); }
+    bool operator==(const char* s) const { return strcmp(data, s) == 0; }
+    bool operator!=(const char* s) const { return strcmp(data, s) != 0; }
+};
+
+typedef std::vector<CommandToken> CommandArgs;
+
 /**
  * Adaptation interface (probes and effectors)
+ *
+ * Commands are lines of space-separated tokens. A line split across
+ * several reads is kept in the client's receive buffer until its end
+ * arrives. The handlers append their replies to the reply buffer
  */
 class AdaptInterface : public omnetpp::cSimpleModule
 {
 public:
+    typedef std::function<void(const CommandArgs&)> CommandHandler;
+
     AdaptInterface();
     virtual ~AdaptInterface();
 
 protected:
-    std::map<std::string, std::function<std::string(const std::vector<std::string>&)>> commandHandlers;
     Model* pModel;
     IProbe* pProbe;
 
+    /** replies to the commands being processed, reused for every input */
+    std::string reply;
+
     virtual void initialize();
     virtual void handleMessage(cMessage *msg);
 
-    virtual std::string cmdAddServer(const std::vector<std::string>& args);
-    virtual std::string cmdRemoveServer(const std::vector<std::string>& args);
-    virtual std::string cmdSetDimmer(const std::vector<std::string>& args);
-    virtual std::string cmdIncreaseDimmer(const std::vector<std::string>& args);
-    virtual std::string cmdDecreaseDimmer(const std::vector<std::string>& args);
-    virtual std::string cmdDivertTraffic(const std::vector<std::string>& args);
-    virtual std::string cmdGetAvgResponseTime(const std::vector<std::string>& args);
-    virtual std::string cmdGetTraffic(const std::vector<std::string>& args);
-
-    virtual std::string cmdGetDimmer(const std::vector<std::string>& args);
-    virtual std::string cmdGetServers(const std::vector<std::string>& args);
-    virtual std::string cmdGetActiveServers(const std::vector<std::string>& args);
-    virtual std::string cmdGetMaxServers(const std::vector<std::string>& args);
-    virtual std::string cmdGetUtilization(const std::vector<std::string>& args);
-    virtual std::string cmdGetBasicResponseTime(const std::vector<std::string>& args);
-    virtual std::string cmdGetBasicThroughput(const std::vector<std::string>& args);
-    virtual std::string cmdGetOptResponseTime(const std::vector<std::string>& args);
-    virtual std::string cmdGetOptThroughput(const std::vector<std::string>& args);
-    virtual std::string cmdGetArrivalRate(const std::vector<std::string>& args);
+    /**
+     * Adds a command, or replaces the handler of an existing one. Commands
+     * must be registered before initialize(), which builds the dispatch table
+     */
+    void registerCommand(const std::string& name, CommandHandler handler);
+
+    /** appends a value and the end of line to the reply */
+    void appendReply(double value);
+    void appendReply(int value);
+
+    virtual void cmdAddServer(const CommandArgs& args);
+    virtual void cmdRemoveServer(const CommandArgs& args);
+
+    /**
+     * Suspends servers of a type (the first argument), keeping their cache
+     * warm. The optional second argument is the number of servers
+     */
+    virtual void cmdSuspendServer(const CommandArgs& args);
+
+    /**
+     * Resumes suspended servers of a type (the first argument). The
+     * optional second argument is the number of servers
+     */
+    virtual void cmdResumeServer(const CommandArgs& args);
+    virtual void cmdGetSuspendedServers(const CommandArgs& args);
+    virtual void cmdSetDimmer(const CommandArgs& args);
+    virtual void cmdIncreaseDimmer(const CommandArgs& args);
+    virtual void cmdDecreaseDimmer(const CommandArgs& args);
+    virtual void cmdDivertTraffic(const CommandArgs& args);
+    virtual void cmdGetAvgResponseTime(const CommandArgs& args);
+    virtual void cmdGetTraffic(const CommandArgs& args);
+
+    virtual void cmdGetDimmer(const CommandArgs& args);
+    virtual void cmdGetServers(const CommandArgs& args);
+    virtual void cmdGetActiveServers(const CommandArgs& args);
+    virtual void cmdGetMaxServers(const CommandArgs& args);
+
+    /**
+     * Replies with the names of the server types, in type id order
+     */
+    virtual void cmdGetServerTypes(const CommandArgs& args);
+    virtual void cmdGetUtilization(const CommandArgs& args);
+    virtual void cmdGetBasicResponseTime(const CommandArgs& args);
+    virtual void cmdGetBasicThroughput(const CommandArgs& args);
+    virtual void cmdGetOptResponseTime(const CommandArgs& args);
+    virtual void cmdGetOptThroughput(const CommandArgs& args);
+    virtual void cmdGetArrivalRate(const CommandArgs& args);
+    virtual void cmdGetQueueLength(const CommandArgs& args);
+    virtual void cmdGetQueueingDelay(const CommandArgs& args);
+
+    /**
+     * Replies with a response time percentile. The optional argument
+     * (basic|opt) restricts it to one request class
+     */
+    virtual void cmdGetResponseTimePercentile(double percentile, const CommandArgs& args);
+
+    /**
+     * Gets a server type from a command argument, which can be either its
+     * name or its id
+     *
+     * @return the server type, or NONE if the argument is not a valid type
+     */
+    MTServerType::ServerType getServerTypeArg(const CommandToken& arg) const;
+
+    /**
+     * Gets the optional number of servers of a command
+     *
+     * @return the number of servers (1 if the argument is not given), or
+     *   0 if it is not valid
+     */
+    int getCountArg(const CommandArgs& args, unsigned index) const;
+
+    /**
+     * @return true if a number of servers of a type can be removed, leaving
+     *   at least one active server that is not being drained
+     */
+    bool canRemoveServers(MTServerType::ServerType serverType, int count) const;
+
+    /**
+     * Replies with an observation of a server type (given as argument)
+     */
+    virtual void cmdGetServerTypeObservation(double ServerObservations::* observation, const CommandArgs& args);
+
+    /**
+     * Replies with an observation of a server (given by name as argument)
+     */
+    virtual void cmdGetServerObservation(double ServerObservations::* observation, const CommandArgs& args);
 
 private:
-    static const unsigned BUFFER_SIZE = 4000;
+    struct Command {
+        std::string name;
+        CommandHandler handler;
+    };
+
+    /** commands in registration order */
+    std::vector<Command> commands;
+
+    /**
+     * Perfect hash table of the commands, with a power of 2 size. Each
+     * command has a slot of its own, so a lookup compares one name at most
+     */
+    std::vector<const Command*> commandTable;
+    uint32_t commandHashSeed;
+
     cMessage *rtEvent;
-    cSocketRTScheduler *rtScheduler;
+    MultiClientRTScheduler *rtScheduler;
+    std::vector<int> readyClients; /**< reused for every rtEvent */
+    CommandArgs args; /**< arguments of the command being executed, reused for every line */
+
+    static uint32_t hashCommand(const char* name, size_t length, uint32_t seed);
+
+    /**
+     * Searches for a hash seed that puts every command in a slot of its own
+     */
+    void buildCommandTable();
+    const Command* findCommand(const CommandToken& name) const;
+
+    /**
+     * Executes the complete lines received from a client, and sends the
+     * replies back to it. The last line is left in the input if its end
+     * has not been received yet
+     */
+    void processInput(int clientId, std::string& input);
 
-    char recvBuffer[BUFFER_SIZE];
-    int numRecvBytes;
-    virtual std::string setDimmer(int level);
+    /**
+     * Splits a line in place into tokens, and executes it
+     */
+    void executeLine(char* line, char* end);
+    void setDimmer(int level);
 };
 
 #endif
@@ -0,0 +1,426 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#include "MultiClientRTScheduler.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace omnetpp;
+
+Register_Class(MultiClientRTScheduler);
+
+Register_GlobalConfigOption(CFGID_MULTICLIENTRTSCHEDULER_PORT, "multiclientrtscheduler-port", CFG_INT, "4242",
+        "When MultiClientRTScheduler is selected as scheduler class: the port number it listens on.");
+
+namespace {
+
+    // epoll keys of the fds that are not clients, which use their id as key
+    const uint64_t LISTENER_KEY = UINT64_MAX;
+    const uint64_t TIMER_KEY = UINT64_MAX - 1;
+
+    const int MAX_EVENTS = 64;
+    const size_t READ_SIZE = 4096;
+
+    // a client is closed when more than this is waiting to be sent to it (bytes)
+    const size_t MAX_SEND_BUFFER = 1 << 20;
+
+    // while waiting, the user interface is given control this often (usec)
+    const int64_t IDLE_INTERVAL = 100000;
+}
+
+MultiClientRTScheduler::MultiClientRTScheduler() : port(0), module(nullptr), notificationMsg(nullptr),
+        baseTime(0), listenerFd(-1), epollFd(-1), timerFd(-1), timerTarget(-1),
+        lastIdleTime(0), nextClientId(0) {
+}
+
+MultiClientRTScheduler::~MultiClientRTScheduler() {
+    endRun();
+}
+
+std::string MultiClientRTScheduler::info() const {
+    ostringstream info;
+    info << "multi-client RT scheduler (" << clients.size() << " clients)";
+    return info.str();
+}
+
+int64_t MultiClientRTScheduler::getMonotonicTime() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+void MultiClientRTScheduler::startRun() {
+    baseTime = getMonotonicTime();
+    lastIdleTime = baseTime;
+    module = nullptr;
+    notificationMsg = nullptr;
+    port = getEnvir()->getConfig()->getAsInt(CFGID_MULTICLIENTRTSCHEDULER_PORT);
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epollFd < 0 || timerFd < 0) {
+        throw cRuntimeError("MultiClientRTScheduler: cannot create epoll or timerfd: %s", strerror(errno));
+    }
+    timerTarget = -1;
+    watch(timerFd, TIMER_KEY);
+    setupListener();
+}
+
+void MultiClientRTScheduler::setupListener() {
+    listenerFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenerFd < 0) {
+        throw cRuntimeError("MultiClientRTScheduler: cannot create socket");
+    }
+
+    // so that the simulation can be restarted right away on the same port
+    int enable = 1;
+    if (setsockopt(listenerFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0) {
+        throw cRuntimeError("MultiClientRTScheduler: cannot set socket option");
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+    if (bind(listenerFd, (sockaddr *) &address, sizeof(address)) < 0) {
+        throw cRuntimeError("MultiClientRTScheduler: socket bind() failed: %s", strerror(errno));
+    }
+    listen(listenerFd, SOMAXCONN);
+    watch(listenerFd, LISTENER_KEY);
+}
+
+void MultiClientRTScheduler::watch(int fd, uint64_t key) {
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = key;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        throw cRuntimeError("MultiClientRTScheduler: epoll_ctl() failed: %s", strerror(errno));
+    }
+}
+
+void MultiClientRTScheduler::watchOutput(int clientId, bool output) {
+    epoll_event event;
+    event.events = output ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.u64 = clientId;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, clients.at(clientId).fd, &event) < 0) {
+        throw cRuntimeError("MultiClientRTScheduler: epoll_ctl() failed: %s", strerror(errno));
+    }
+}
+
+void MultiClientRTScheduler::endRun() {
+    for (auto& entry : clients) {
+        if (entry.second.fd >= 0) {
+            close(entry.second.fd);
+        }
+    }
+    clients.clear();
+    readyClients.clear();
+    closedClients.clear();
+    for (int* fd : {&listenerFd, &timerFd, &epollFd}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void MultiClientRTScheduler::executionResumed() {
+    baseTime = getMonotonicTime() - simTime().inUnit(SIMTIME_US);
+}
+
+void MultiClientRTScheduler::setInterfaceModule(cModule *mod, cMessage *notifMsg) {
+    if (module) {
+        throw cRuntimeError("MultiClientRTScheduler: setInterfaceModule() already called");
+    }
+    if (!mod || !notifMsg) {
+        throw cRuntimeError("MultiClientRTScheduler: setInterfaceModule(): arguments must be non-nullptr");
+    }
+    module = mod;
+    notificationMsg = notifMsg;
+}
+
+void MultiClientRTScheduler::armTimer(int64_t targetTime) {
+    if (targetTime == timerTarget) {
+        return;
+    }
+    itimerspec timer;
+    memset(&timer, 0, sizeof(timer));
+    if (targetTime >= 0) {
+        timer.it_value.tv_sec = targetTime / 1000000;
+        timer.it_value.tv_nsec = (targetTime % 1000000) * 1000;
+
+        // a zero it_value disarms the timer
+        if (timer.it_value.tv_sec == 0 && timer.it_value.tv_nsec == 0) {
+            timer.it_value.tv_nsec = 1;
+        }
+    }
+    timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &timer, nullptr);
+    timerTarget = targetTime;
+}
+
+void MultiClientRTScheduler::acceptClients() {
+    int fd;
+    while ((fd = accept4(listenerFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        int clientId = nextClientId++;
+        clients[clientId] = Client{fd, string(), string(), false, false};
+        watch(fd, clientId);
+        EV << "MultiClientRTScheduler: client " << clientId << " connected\n";
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        throw cRuntimeError("MultiClientRTScheduler: accept() failed: %s", strerror(errno));
+    }
+}
+
+bool MultiClientRTScheduler::receive(int clientId) {
+    Client& client = clients.at(clientId);
+    size_t received = 0;
+    bool disconnected = false;
+    while (true) {
+        size_t length = client.recvBuffer.length();
+        client.recvBuffer.resize(length + READ_SIZE);
+        ssize_t n = recv(client.fd, &client.recvBuffer[length], READ_SIZE, 0);
+        client.recvBuffer.resize(length + max<ssize_t>(n, 0));
+        if (n > 0) {
+            received += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            disconnected = (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+            break;
+        }
+    }
+
+    if (received > 0 && !client.ready) {
+        client.ready = true;
+        readyClients.push_back(clientId);
+    }
+    if (disconnected) {
+        EV << "MultiClientRTScheduler: client " << clientId << " disconnected\n";
+        closeClient(clientId);
+    }
+    return received > 0;
+}
+
+void MultiClientRTScheduler::closeClient(int clientId) {
+    Client& client = clients.at(clientId);
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+    close(client.fd);
+    client.fd = -1;
+    client.closed = true;
+    client.sendBuffer.clear();
+
+    /*
+     * the commands it sent before closing are still executed, and its
+     * buffer stays valid until the next takeReadyClients() in any case,
+     * since it may be in use
+     */
+    if (!client.ready) {
+        closedClients.push_back(clientId);
+    }
+}
+
+void MultiClientRTScheduler::notify() {
+    if (notificationMsg->isScheduled()) {
+        return;
+    }
+
+    simtime_t eventTime(getMonotonicTime() - baseTime, SIMTIME_US);
+    notificationMsg->setArrival(module->getId(), -1, max(eventTime, simTime()));
+    getSimulation()->getFES()->insert(notificationMsg);
+}
+
+void MultiClientRTScheduler::takeReadyClients(std::vector<int>& clientIds) {
+
+    // the data of the clients closed before the last call has been consumed by now
+    for (int clientId : closedClients) {
+        clients.erase(clientId);
+    }
+    closedClients.clear();
+
+    clientIds.swap(readyClients);
+    readyClients.clear();
+    for (int clientId : clientIds) {
+        Client& client = clients.at(clientId);
+        client.ready = false;
+        if (client.closed) {
+            closedClients.push_back(clientId);
+        }
+    }
+}
+
+std::string* MultiClientRTScheduler::getReceiveBuffer(int clientId) {
+    auto it = clients.find(clientId);
+    return (it != clients.end()) ? &it->second.recvBuffer : nullptr;
+}
+
+void MultiClientRTScheduler::sendBytes(int clientId, const char *buf, size_t numBytes) {
+    auto it = clients.find(clientId);
+    if (it == clients.end() || it->second.closed) {
+        return;
+    }
+
+    Client& client = it->second;
+
+    // data goes after the data already waiting, if any
+    size_t sent = 0;
+    if (client.sendBuffer.empty()) {
+        ssize_t n = sendAvailable(clientId, buf, numBytes);
+        if (n < 0) {
+            closeClient(clientId);
+            return;
+        }
+        sent = n;
+    }
+    if (sent == numBytes) {
+        return;
+    }
+
+    // replies are short, so the socket buffer only fills up if the client stops reading
+    if (client.sendBuffer.length() + (numBytes - sent) > MAX_SEND_BUFFER) {
+        EV << "MultiClientRTScheduler: client " << clientId << " is not reading what is sent to it\n";
+        closeClient(clientId);
+        return;
+    }
+    if (client.sendBuffer.empty()) {
+        watchOutput(clientId, true);
+    }
+    client.sendBuffer.append(buf + sent, numBytes - sent);
+}
+
+ssize_t MultiClientRTScheduler::sendAvailable(int clientId, const char *buf, size_t numBytes) {
+    int fd = clients.at(clientId).fd;
+    size_t sent = 0;
+    while (sent < numBytes) {
+        ssize_t n = send(fd, buf + sent, numBytes - sent, MSG_NOSIGNAL);
+        if (n >= 0) {
+            sent += n;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            EV << "MultiClientRTScheduler: cannot send to client " << clientId << ": " << strerror(errno) << "\n";
+            return -1;
+        }
+    }
+    return sent;
+}
+
+void MultiClientRTScheduler::flush(int clientId) {
+    Client& client = clients.at(clientId);
+    ssize_t n = sendAvailable(clientId, client.sendBuffer.data(), client.sendBuffer.length());
+    if (n < 0) {
+        closeClient(clientId);
+        return;
+    }
+    client.sendBuffer.erase(0, n);
+    if (client.sendBuffer.empty()) {
+        watchOutput(clientId, false);
+    }
+}
+
+int MultiClientRTScheduler::receiveUntil(int64_t targetTime) {
+    armTimer(targetTime);
+
+    epoll_event events[MAX_EVENTS];
+    while (true) {
+        int64_t now = getMonotonicTime();
+        if (targetTime >= 0 && now >= targetTime) {
+            return 0;
+        }
+
+        // give control to the user interface regularly
+        if (now - lastIdleTime >= IDLE_INTERVAL) {
+            lastIdleTime = now;
+            if (getEnvir()->idle()) {
+                return -1;
+            }
+        }
+
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, IDLE_INTERVAL / 1000);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw cRuntimeError("MultiClientRTScheduler: epoll_wait() failed: %s", strerror(errno));
+        }
+
+        // the timer only wakes it up, the time is checked at the start of the loop
+        bool received = false;
+        for (int i = 0; i < count; i++) {
+            uint64_t key = events[i].data.u64;
+            uint64_t counter;
+            if (key == LISTENER_KEY) {
+                acceptClients();
+            } else if (key == TIMER_KEY) {
+                if (read(timerFd, &counter, sizeof(counter)) < 0) {
+                    // already reset by re-arming it
+                }
+            } else {
+                int clientId = (int) key;
+                if ((events[i].events & EPOLLOUT) && clients.count(clientId) && !clients.at(clientId).closed) {
+                    flush(clientId);
+                }
+                if ((events[i].events & ~EPOLLOUT) && clients.count(clientId) && !clients.at(clientId).closed) {
+                    received |= receive(clientId);
+                }
+            }
+        }
+
+        if (received) {
+            notify();
+            return 1;
+        }
+    }
+}
+
+cEvent *MultiClientRTScheduler::guessNextEvent() {
+    return sim->getFES()->peekFirst();
+}
+
+cEvent *MultiClientRTScheduler::takeNextEvent() {
+    if (!module) {
+        throw cRuntimeError("MultiClientRTScheduler: setInterfaceModule() not called: it must be called from a module's initialize() function");
+    }
+
+    cEvent *event = sim->getFES()->peekFirst();
+
+    // wait until the time of the next event, or until something comes from outside
+    int64_t targetTime = event ? baseTime + event->getArrivalTime().inUnit(SIMTIME_US) : -1;
+    if (targetTime < 0 || targetTime > getMonotonicTime()) {
+        int status = receiveUntil(targetTime);
+        if (status == -1) {
+            return nullptr;  // interrupted by user
+        }
+        if (status == 1) {
+            event = sim->getFES()->peekFirst();  // received something
+        }
+    }
+
+    cEvent *tmp = sim->getFES()->removeFirst();
+    ASSERT(tmp == event);
+    return event;
+}
+
+void MultiClientRTScheduler::putBackEvent(cEvent *event) {
+    sim->getFES()->putBackFirst(event);
+}
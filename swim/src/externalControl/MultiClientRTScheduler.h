@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#ifndef MULTICLIENTRTSCHEDULER_H_
+#define MULTICLIENTRTSCHEDULER_H_
+
+#include <omnetpp.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Real-time scheduler that accepts any number of TCP clients
+ *
+ * Unlike cSocketRTScheduler, which serves one connection at a time, every
+ * client has its own receive buffer, and replies are sent to the client
+ * that sent the command. It waits with epoll on the sockets and a timerfd
+ * armed for the time of the next event, so that it reacts to input as soon
+ * as it arrives.
+ * It only runs on Linux.
+ *
+ * The interface module calls setInterfaceModule() from its initialize().
+ * When it gets the notification message, it calls takeReadyClients() and
+ * consumes the data in the receive buffer of each of them
+ */
+class MultiClientRTScheduler : public omnetpp::cScheduler
+{
+    struct Client {
+        int fd;
+        std::string recvBuffer;
+        std::string sendBuffer; /**< data the socket did not take yet, sent when it becomes writable */
+        bool ready; /**< in readyClients */
+        bool closed; /**< closed by the peer, and removed once its data has been taken */
+    };
+
+    int port;
+    omnetpp::cModule *module;
+    omnetpp::cMessage *notificationMsg;
+
+    int64_t baseTime; // in microseconds of the monotonic clock
+    int listenerFd;
+    int epollFd;
+    int timerFd;
+    int64_t timerTarget; // time the timer is armed for, or -1 if disarmed
+    int64_t lastIdleTime;
+
+    int nextClientId;
+    std::unordered_map<int, Client> clients; /**< indexed by client id */
+    std::vector<int> readyClients; /**< clients with data not taken yet */
+    std::vector<int> closedClients; /**< closed clients whose data has been taken */
+
+    static int64_t getMonotonicTime();
+
+    void setupListener();
+    void watch(int fd, uint64_t key);
+
+    /**
+     * Sets whether epoll also reports when a client can be sent more data
+     */
+    void watchOutput(int clientId, bool output);
+    void armTimer(int64_t targetTime);
+    void acceptClients();
+
+    /**
+     * Reads all the data available from a client
+     *
+     * @return true if data was received
+     */
+    bool receive(int clientId);
+
+    /**
+     * Sends as much data to a client as its socket takes without blocking
+     *
+     * @return the number of bytes sent, or -1 if the client has to be closed
+     */
+    ssize_t sendAvailable(int clientId, const char *buf, size_t numBytes);
+
+    /**
+     * Sends the data in the send buffer of a client that became writable
+     */
+    void flush(int clientId);
+    void closeClient(int clientId);
+    void notify();
+
+    /**
+     * Waits until targetTime, or until data is received
+     *
+     * @param targetTime -1 to wait until data is received
+     * @return 1 if data was received, 0 if targetTime was reached, -1 if
+     *   interrupted by the user
+     */
+    int receiveUntil(int64_t targetTime);
+
+  public:
+    MultiClientRTScheduler();
+    virtual ~MultiClientRTScheduler();
+
+    virtual std::string info() const override;
+    virtual void startRun() override;
+    virtual void endRun() override;
+    virtual void executionResumed() override;
+
+    /**
+     * To be called from the initialize() of the module that receives the
+     * data, which gets notificationMsg whenever clients send data
+     */
+    virtual void setInterfaceModule(omnetpp::cModule *module, omnetpp::cMessage *notificationMsg);
+
+    /**
+     * Takes the clients that have sent data since the last call
+     *
+     * @param clientIds set to the ids of the clients
+     */
+    virtual void takeReadyClients(std::vector<int>& clientIds);
+
+    /**
+     * @return the data received from a client and not consumed yet, which
+     *   the caller erases as it consumes it, or nullptr if there is no
+     *   such client
+     */
+    virtual std::string* getReceiveBuffer(int clientId);
+
+    /**
+     * Sends to a client without blocking. What its socket does not take
+     * is sent when it becomes writable, and a client that does not read
+     * is closed when too much data is waiting for it. Data for clients
+     * that have disconnected is dropped
+     */
+    virtual void sendBytes(int clientId, const char *buf, size_t numBytes);
+
+    virtual omnetpp::cEvent *guessNextEvent() override;
+    virtual omnetpp::cEvent *takeNextEvent() override;
+    virtual void putBackEvent(omnetpp::cEvent *event) override;
+};
+
+#endif /* MULTICLIENTRTSCHEDULER_H_ */
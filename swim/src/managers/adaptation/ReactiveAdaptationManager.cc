@@ -65,7 +65,7 @@ Tactic* ReactiveAdaptationManager::evaluate() {
                 dimmer = min(1.0, dimmer + dimmerStep);
                 pMacroTactic->addTactic(new SetDimmerTactic(dimmer));
             } else if (!isServerBooting
-                    && pModel->getServers() > 1) {
+                    && pModel->getServers() - pModel->getTotalDrainingServers() > 1) {
                 pMacroTactic->addTactic(new RemoveServerTactic);
             }
         }
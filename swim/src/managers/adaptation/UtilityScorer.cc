@@ -20,6 +20,36 @@
 
 const char* UtilityScorer::OPT_REVENUE = "optRevenue";
 const char* UtilityScorer::PENALTY_MULTIPLIER = "penaltyMultiplier";
+const char* UtilityScorer::RESPONSE_TIME_PERCENTILE = "responseTimePercentile";
+
+double UtilityScorer::getSLAResponseTime(const Observations& observations)
+{
+    const auto& sysmodule = omnetpp::getSimulation()->getSystemModule();
+    if (!sysmodule->hasPar(RESPONSE_TIME_PERCENTILE)) {
+        return observations.avgResponseTime;
+    }
+
+    int percentile = sysmodule->par(RESPONSE_TIME_PERCENTILE);
+    double responseTime;
+    switch (percentile) {
+    case 0:
+        return observations.avgResponseTime;
+    case 50:
+        responseTime = observations.responseTimeP50;
+        break;
+    case 95:
+        responseTime = observations.responseTimeP95;
+        break;
+    case 99:
+        responseTime = observations.responseTimeP99;
+        break;
+    default:
+        throw omnetpp::cRuntimeError("UtilityScorer: unsupported %s %d", RESPONSE_TIME_PERCENTILE, percentile);
+    }
+
+    // fall back to the average if the probe does not compute percentiles
+    return (responseTime < 0) ? observations.avgResponseTime : responseTime;
+}
 
 /**
  * returns utility per unit of time;
@@ -49,7 +79,8 @@ double UtilityScorer::getAccruedUtility(const Model& model, const Configuration&
 
     double positiveUtility = round((throughput * (brownoutFactor * brownoutRevenue + (1 - brownoutFactor) * normalRevenue)));
 
-    double utility = ((observations.avgResponseTime>RT_THRESHOLD || observations.avgResponseTime < 0) ? std::min(0.0, throughput * normalRevenue - latePenalty) : positiveUtility);
+    double responseTime = getSLAResponseTime(observations);
+    double utility = ((responseTime>RT_THRESHOLD || responseTime < 0) ? std::min(0.0, throughput * normalRevenue - latePenalty) : positiveUtility);
 
     return utility / model.getEvaluationPeriod();
 }
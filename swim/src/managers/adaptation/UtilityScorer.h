@@ -33,6 +33,14 @@ protected:
 
     static const char* OPT_REVENUE;
     static const char* PENALTY_MULTIPLIER;
+    static const char* RESPONSE_TIME_PERCENTILE;
+
+    /**
+     * Returns the response time that is checked against the threshold:
+     * the average, or a percentile if the responseTimePercentile parameter
+     * is set and the probe provides it
+     */
+    static double getSLAResponseTime(const Observations& observations);
 
 public:
 
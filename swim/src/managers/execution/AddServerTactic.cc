@@ -21,12 +21,24 @@
 
 #include "AddServerTactic.h"
 
+AddServerTactic::AddServerTactic(MTServerType::ServerType serverType, unsigned count)
+    : serverType(serverType), count(count) {}
+
 void AddServerTactic::execute(ExecutionManager* execMgr) {
-    execMgr->addServer();
+    if (serverType == MTServerType::NONE) {
+        for (unsigned i = 0; i < count; i++) {
+            execMgr->addServer();
+        }
+    } else {
+        execMgr->addServers(serverType, count);
+    }
 }
 
 void AddServerTactic::printOn(std::ostream& os) const {
     os << "AddServer";
+    if (serverType != MTServerType::NONE || count != 1) {
+        os << "(" << serverType << ", " << count << ")";
+    }
 }
 
 AddServerTactic::~AddServerTactic() {
@@ -23,9 +23,18 @@
 #define ADDSERVERTACTIC_H_
 
 #include "Tactic.h"
+#include <modules/MTServerType.h>
 
 class AddServerTactic: public Tactic {
+    MTServerType::ServerType serverType;
+    unsigned count;
 public:
+
+    /**
+     * @param serverType type of the servers to add, NONE for the default
+     * @param count number of servers to add, which boot concurrently
+     */
+    AddServerTactic(MTServerType::ServerType serverType = MTServerType::NONE, unsigned count = 1);
     virtual void execute(ExecutionManager* execMgr);
     virtual void printOn(std::ostream& os) const;
     virtual ~AddServerTactic();
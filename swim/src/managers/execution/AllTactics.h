@@ -25,6 +25,8 @@
 #include "MacroTactic.h"
 #include "AddServerTactic.h"
 #include "RemoveServerTactic.h"
+#include "SuspendServerTactic.h"
+#include "ResumeServerTactic.h"
 #include "SetBrownoutTactic.h"
 #include "SetDimmerTactic.h"
 
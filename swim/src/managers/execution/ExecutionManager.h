@@ -15,10 +15,16 @@
 #ifndef EXECUTIONMANAGER_H_
 #define EXECUTIONMANAGER_H_
 
+#include <modules/MTServerType.h>
+
 class ExecutionManager {
 public:
     virtual void addServer() = 0;
     virtual void removeServer() = 0;
+    virtual void addServers(MTServerType::ServerType serverType, unsigned count) = 0;
+    virtual void removeServers(MTServerType::ServerType serverType, unsigned count) = 0;
+    virtual void suspendServers(MTServerType::ServerType serverType, unsigned count) = 0;
+    virtual void resumeServers(MTServerType::ServerType serverType, unsigned count) = 0;
     virtual void setBrownout(double factor) = 0;
     virtual ~ExecutionManager() {}
 };
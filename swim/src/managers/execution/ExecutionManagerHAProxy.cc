@@ -14,100 +14,181 @@
  *******************************************************************************/
 #include "ExecutionManagerHAProxy.h"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
+#include <stdexcept>
 #include <util/Utils.h>
 
 using namespace std;
 using namespace omnetpp;
 
-/*Define_Module(ExecutionManagerHAProxy);
+Define_Module(ExecutionManagerHAProxy);
+
+ExecutionManagerHAProxy::ExecutionManagerHAProxy() : controlLatencySignal(0) {
+}
 
 void ExecutionManagerHAProxy::initialize()
 {
     ExecutionManagerModBase::initialize();
     loadBalancer.setAddress(par("HAProxySocketPath").stringValue());
-    pModel->setServerThreads(getSimulation()->getSystemModule()->par("serverThreads"));
+    backend = par("backend").stdstringValue();
+    dimmerMap = par("dimmerMap").stdstringValue();
+    controlLatencySignal = registerSignal("controlLatency");
 }
 
+void ExecutionManagerHAProxy::handleMessage(cMessage *msg) {
+    if (completeRemoveMsgs.erase(msg) > 0) {
+        BootComplete* completeRemove = check_and_cast<BootComplete*>(msg);
+        notifyRemoveServerCompleted(MTServerType::ServerType(completeRemove->getServerType()),
+                completeRemove->getModuleId());
+        delete msg;
+    } else {
+        ExecutionManagerModBase::handleMessage(msg);
+    }
+}
 
-BootComplete* ExecutionManagerHAProxy::doAddServer(bool instantaneous) {
-    int serverCount = pModel->getServers();
-    if (serverCount == 0) {
-*/
-        /*
-         * if there should be no servers (possibly start of sim) initialize several things:
-         *  -set server params in model
-         *  -set brownout in haproxy
-         *  -make sure all servers are disabled
-         *  (all this should probably be in initialize in a second phase
-         */
-/*        double variance = 0.0;
-        double mean = Utils::getMeanAndVarianceFromParameter(getParentModule()->par("serviceTime"), &variance);
-        pModel->setServiceTime(mean, variance);
-        mean = Utils::getMeanAndVarianceFromParameter(getParentModule()->par("lowFidelityServiceTime"), &variance);
-        pModel->setLowFidelityServiceTime(mean, variance);
-        double brownoutFactor = getParentModule()->par("brownoutFactor");
-        pModel->setBrownoutFactor(brownoutFactor);
-        doSetBrownout(brownoutFactor);
-        for (int i = 1; i <= pModel->getMaxServers(); i++) {
-            disableServer(i);
+void ExecutionManagerHAProxy::setUp() {
+    unsigned types = pModel->getNumberOfServerTypes();
+    firstServerNumber.resize(types + 1);
+    serverNumbers.resize(types + 1);
+
+    double serviceTimeVariance = 0.0;
+    double serviceTime = Utils::getMeanAndVarianceFromParameter(par("serviceTime"), &serviceTimeVariance);
+    double lowFidelityServiceTimeVariance = 0.0;
+    double lowFidelityServiceTime = Utils::getMeanAndVarianceFromParameter(par("lowFidelityServiceTime"),
+            &lowFidelityServiceTimeVariance);
+    pModel->setServerThreads(par("serverThreads"));
+
+    // make sure all servers are disabled, so that they are only enabled when added
+    int serverNumber = 1;
+    commands.clear();
+    for (unsigned type = MTServerType::NONE + 1; type <= types; type++) {
+        MTServerType::ServerType serverType = MTServerType::ServerType(type);
+        firstServerNumber[type] = serverNumber;
+        for (int i = 0; i < pModel->getMaxServers(serverType); i++) {
+            addServerCommand("disable", serverNumber++);
         }
-<<<<<<< HEAD
-	//int weight = getParentModule()->par("weight");
-	//pModel->setServerWeight(weight);
-	//int activeConnections = getParentModule()->par("activeConnections");
-	//pModel->setActiveConnections(activeConnections);
-=======
->>>>>>> fc568acc6e702a7b574ac602ba7dad7a5b6cf2db
+        enabledServers.clear();
+
+        // the servers are not simulated, so they all have the same parameters
+        pModel->setServiceTime(serviceTime, serviceTimeVariance, serverType);
+        pModel->setLowFidelityServiceTime(lowFidelityServiceTime, lowFidelityServiceTimeVariance, serverType);
     }
+    executeCommands();
 
+    double brownoutFactor = par("brownoutFactor");
+    pModel->setBrownoutFactor(brownoutFactor);
+    doSetBrownout(brownoutFactor);
+}
 
-    BootComplete* pBootComplete = new BootComplete;
+void ExecutionManagerHAProxy::addServerCommand(const char* action, int serverNumber) {
+    ostringstream cmd;
+    cmd << action << " server " << backend << "/#" << serverNumber;
+    commands.push_back(cmd.str());
+}
 
-    // use module id as server index (starting from 1)
-    pBootComplete->setModuleId(serverCount + 1);
-    return pBootComplete;
+void ExecutionManagerHAProxy::executeCommands() {
+    auto start = chrono::steady_clock::now();
+    vector<string> replies;
+    try {
+        replies = loadBalancer.executeCommands(commands);
+    } catch (const runtime_error& e) {
+        error("%s", e.what());
+    }
+    emit(controlLatencySignal, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+
+    // HAProxy only replies something other than an empty line if the command failed
+    for (unsigned i = 0; i < replies.size(); i++) {
+        if (replies[i].find_first_not_of(" \r\n") != string::npos) {
+            error("HAProxy command '%s' failed: %s", commands[i].c_str(), replies[i].c_str());
+        }
+    }
+    commands.clear();
 }
 
-void ExecutionManagerHAProxy::doAddServerBootComplete(
-        BootComplete* bootComplete) {
+BootComplete* ExecutionManagerHAProxy::doAddServer(MTServerType::ServerType serverType, bool instantaneous) {
+    if (firstServerNumber.empty()) {
+        setUp();
+    }
 
-    ostringstream cmd;
-    cmd << "enable server servers/#";
-    cmd << bootComplete->getModuleId();
-    cmd << '\n';
-    loadBalancer.executeCommand(cmd.str());
+    // take the lowest number of the type that is not in use
+    vector<int>& numbers = serverNumbers[serverType];
+    int serverNumber = firstServerNumber[serverType];
+    while (find(numbers.begin(), numbers.end(), serverNumber) != numbers.end()) {
+        serverNumber++;
+    }
+    ASSERT(serverNumber < firstServerNumber[serverType] + pModel->getMaxServers(serverType));
+    numbers.push_back(serverNumber);
+
+    // the server is enabled in HAProxy when it has booted
+    BootComplete* pBootComplete = new BootComplete;
+    pBootComplete->setModuleId(serverNumber);
+    return pBootComplete;
 }
 
-void ExecutionManagerHAProxy::disableServer(int serverNumber) {
-    ostringstream cmd;
-    cmd << "disable server servers/#";
-    cmd << serverNumber;
-    cmd << '\n';
-    loadBalancer.executeCommand(cmd.str());
+void ExecutionManagerHAProxy::doAddServerBootComplete(BootComplete* bootComplete) {
+    addServerCommand("enable", bootComplete->getModuleId());
+    executeCommands();
+    enabledServers.insert(bootComplete->getModuleId());
 }
 
-BootComplete* ExecutionManagerHAProxy::doRemoveServer() {
-    int serverNumber = pModel->getServers();
+BootComplete* ExecutionManagerHAProxy::doRemoveServer(MTServerType::ServerType serverType, int serverId) {
+    ASSERT(serverType < (int) serverNumbers.size() && !serverNumbers[serverType].empty());
+    vector<int>& numbers = serverNumbers[serverType];
+    if (serverId < 0) {
+
+        // remove the server added last, which may still be booting
+        serverId = numbers.back();
+        numbers.pop_back();
+    } else {
+        vector<int>::iterator it = find(numbers.begin(), numbers.end(), serverId);
+        ASSERT(it != numbers.end());
+        numbers.erase(it);
+    }
 
-    disableServer(serverNumber);
+    // HAProxy lets the ongoing requests finish, so the removal completes right away
+    addServerCommand("disable", serverId);
+    executeCommands();
+    enabledServers.erase(serverId);
 
-    // we don't wait, notify now
-    ostringstream serverId;
-    serverId << "server";
-    serverId << serverNumber;
-    notifyRemoveServerCompleted(serverId.str().c_str());
+    BootComplete* completeRemoveMsg = new BootComplete("completeRemove");
+    completeRemoveMsg->setModuleId(serverId);
+    completeRemoveMsg->setServerType(serverType);
+    completeRemoveMsgs.insert(completeRemoveMsg);
+    scheduleAt(simTime(), completeRemoveMsg);
 
-    // use module id as server index (starting from 1)
     BootComplete* pBootComplete = new BootComplete;
-    pBootComplete->setModuleId(serverNumber);
+    pBootComplete->setModuleId(serverId);
     return pBootComplete;
 }
 
 void ExecutionManagerHAProxy::doSetBrownout(double factor) {
     ostringstream cmd;
-    cmd << "set map /tmp/dimmerMap 1 ";
+    cmd << "set map " << dimmerMap << " 1 ";
     cmd << 1 - factor; // translated to dimmer
-    cmd << '\n';
-    loadBalancer.executeCommand(cmd.str());
-}*/
+    commands.push_back(cmd.str());
+    executeCommands();
+}
+
+cModule* ExecutionManagerHAProxy::getServerModule(int serverId) const {
+    return nullptr;
+}
+
+bool ExecutionManagerHAProxy::hasServer(MTServerType::ServerType serverType, int serverId) const {
+    if (serverType <= MTServerType::NONE || serverType >= (int) serverNumbers.size()) {
+        return false;
+    }
+    const vector<int>& numbers = serverNumbers[serverType];
+    return find(numbers.begin(), numbers.end(), serverId) != numbers.end();
+}
+
+bool ExecutionManagerHAProxy::isServerEnabled(int serverNumber) const {
+    return enabledServers.find(serverNumber) != enabledServers.end();
+}
+
+ExecutionManagerHAProxy::~ExecutionManagerHAProxy() {
+    for (cMessage* msg : completeRemoveMsgs) {
+        cancelAndDelete(msg);
+    }
+}
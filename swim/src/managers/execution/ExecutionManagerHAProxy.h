@@ -12,39 +12,93 @@
  * Released under a BSD license, please see license.txt for full terms.
  * DM-0003883
  *******************************************************************************/
-/*#ifndef __PLASASIM_EXECUTIONMANAGERHAPROXY_H_
+#ifndef __PLASASIM_EXECUTIONMANAGERHAPROXY_H_
 #define __PLASASIM_EXECUTIONMANAGERHAPROXY_H_
 
 #include "ExecutionManagerModBase.h"
 #include "util/HAProxySocketCommand.h"
-*/
-/*
+#include <set>
+#include <string>
+#include <vector>
+
+/**
  * Execution Manager to control HAProxy
+ *
+ * All the servers are in one HAProxy backend, named <backend>/#<number>.
+ * Each server type has a range of maxServers consecutive numbers, in the
+ * order of the type ids, so with 2 types of 3 servers, type 1 has servers
+ * 1 to 3, and type 2 servers 4 to 6. The server number is the server id
+ * used in the BootComplete messages and in removeServer()
  */
-/*class ExecutionManagerHAProxy : public ExecutionManagerModBase
+class ExecutionManagerHAProxy : public ExecutionManagerModBase
 {
     HAProxySocketCommand loadBalancer;
-  protected:
-    virtual void initialize();
+    std::string backend;
+    std::string dimmerMap;
+    omnetpp::simsignal_t controlLatencySignal;
+
+    /** first server number of each type, indexed by type id. Empty until the first server is added */
+    std::vector<int> firstServerNumber;
 
+    /** numbers of the booting and active servers of each type in the order they were added, indexed by type id */
+    std::vector<std::vector<int>> serverNumbers;
 
-    void disableServer(int serverNumber);
+    /** numbers of the servers enabled in HAProxy, which are the active ones */
+    std::set<int> enabledServers;
+
+    std::set<omnetpp::cMessage*> completeRemoveMsgs;
+    std::vector<std::string> commands; /**< reused for every batch of commands */
+
+    /**
+     * Disables all the servers, and sets the parameters of the server
+     * types in the model. It is done when the first server is added,
+     * because the server types are not known before the model has been
+     * initialized
+     */
+    void setUp();
+
+    /**
+     * Sends the commands in one round trip, and emits the time it took
+     */
+    void executeCommands();
+
+    void addServerCommand(const char* action, int serverNumber);
+
+  protected:
+    virtual void initialize();
+    virtual void handleMessage(omnetpp::cMessage *msg);
 
     // target-specific methods (e.g., actual servers, sim servers, etc.)
-*/
+
     /**
      * @return BootComplete* to be handled later by doAddServerBootComplete()
      */
-/*    virtual BootComplete* doAddServer(bool instantaneous = false);
+    virtual BootComplete* doAddServer(MTServerType::ServerType serverType, bool instantaneous = false);
     virtual void doAddServerBootComplete(BootComplete* bootComplete);
-*/
+
     /**
      * @return BootComplete* identical in content (not the pointer itself) to
      *   what doAddServer() would have return for this server
      */
-/*    virtual BootComplete* doRemoveServer();
+    virtual BootComplete* doRemoveServer(MTServerType::ServerType serverType, int serverId = -1);
     virtual void doSetBrownout(double factor);
+
+    /**
+     * @return nullptr, since the servers are not modules
+     */
+    virtual omnetpp::cModule* getServerModule(int serverId) const;
+
+  public:
+    ExecutionManagerHAProxy();
+    virtual ~ExecutionManagerHAProxy();
+
+    virtual bool hasServer(MTServerType::ServerType serverType, int serverId) const;
+
+    /**
+     * @param serverNumber number of the server in the HAProxy backend
+     * @return true if the server is enabled in HAProxy
+     */
+    bool isServerEnabled(int serverNumber) const;
 };
 
 #endif
-*/
@@ -16,9 +16,12 @@
 #include <sstream>
 #include <boost/tokenizer.hpp>
 #include <cstdlib>
+#include <algorithm>
 #include "PassiveQueue.h"
+#include "Job.h"
 #include "modules/MTServer.h"
 #include "modules/MTBrownoutServer.h"
+#include "modules/LoadBalancer.h"
 #include <util/Utils.h>
 
 
@@ -29,32 +32,74 @@ Define_Module(ExecutionManagerMod);
 
 const char* SERVER_MODULE_NAME = "server";
 const char* LOAD_BALANCER_MODULE_NAME = "loadBalancer";
+const char* SHARED_QUEUE_MODULE_NAME = "sharedQueue";
 const char* INTERNAL_SERVER_MODULE_NAME = "server";
 const char* INTERNAL_QUEUE_MODULE_NAME = "queue";
 const char* SINK_MODULE_NAME = "classifier";
 
-ExecutionManagerMod::ExecutionManagerMod()
-        : serverBeingRemovedModuleId(-1), completeRemoveMsg(0) {
+const char* ExecutionManagerMod::SIG_SERVER_DRAINING = "serverDraining";
+const char* ExecutionManagerMod::SIG_JOBS_MIGRATED = "jobsMigrated";
+
+ExecutionManagerMod::ExecutionManagerMod() : dispatcher(nullptr), warmPoolSize(0), brownoutFactor(-1), migrateQueuedJobs(true) {
     serverBusySignalId = registerSignal("busy");
+    serverDrainingSignal = registerSignal(SIG_SERVER_DRAINING);
+    jobsMigratedSignal = registerSignal(SIG_JOBS_MIGRATED);
 }
 
 
-void ExecutionManagerMod::initialize() {
-    ExecutionManagerModBase::initialize();
-    getSimulation()->getSystemModule()->subscribe(serverBusySignalId, this);
+void ExecutionManagerMod::initialize(int stage) {
+    if (stage == 0) {
+        ExecutionManagerModBase::initialize();
+        getSimulation()->getSystemModule()->subscribe(serverBusySignalId, this);
+        warmPoolSize = par("warmPoolSize").intValue();
+        migrateQueuedJobs = par("migrateQueuedJobs").boolValue();
+
+        // with a shared queue, the servers are connected to it instead of to the load balancer
+        dispatcher = getParentModule()->getSubmodule(SHARED_QUEUE_MODULE_NAME);
+        if (!dispatcher) {
+            dispatcher = getParentModule()->getSubmodule(LOAD_BALANCER_MODULE_NAME);
+        }
+    } else {
+
+        // server types are known after the model has been initialized
+        warmPools.resize(pModel->getNumberOfServerTypes() + 1);
+        for (unsigned type = MTServerType::NONE + 1; type < warmPools.size(); type++) {
+            MTServerType::ServerType serverType = MTServerType::ServerType(type);
+            while (warmPools[type].size() < warmPoolSize) {
+                ServerEntry& entry = createServer(serverType, POOLED);
+                entry.module->scheduleStart(simTime());
+                entry.module->callInitialize();
+                warmPools[type].push_back(entry.module->getId());
+            }
+        }
+    }
 }
 
 void ExecutionManagerMod::handleMessage(cMessage *msg) {
-    if (msg == completeRemoveMsg) {
-        cModule* module = getSimulation()->getModule(serverBeingRemovedModuleId);
-        MTServerType::ServerType serverType = getServerTypeFromName(module->getFullName());
-        notifyRemoveServerCompleted(serverType);
-        module->gate("out")->disconnect();
-        module->deleteModule();
-        serverBeingRemovedModuleId = -1;
+    if (completeRemoveMsgs.erase(msg) > 0) {
+        ServerEntry& entry = servers.at(check_and_cast<BootComplete*>(msg)->getModuleId());
+        if (entry.state == SUSPENDED) {
+            notifySuspendServerCompleted(entry.type, entry.module);
+        } else {
+            notifyRemoveServerCompleted(entry.type, entry.module);
+        }
 
-        cancelAndDelete(msg);
-        completeRemoveMsg = 0;
+        // disconnect from the sink, and free the gate for the next server
+        cGate* pOutGate = entry.module->gate("out");
+        if (pOutGate->isConnected()) {
+            freeSinkGates.push_back(pOutGate->getNextGate()->getIndex());
+            pOutGate->disconnect();
+        }
+        if (entry.state == SUSPENDED) {
+            if (entry.type >= (int) suspendedServers.size()) {
+                suspendedServers.resize(entry.type + 1);
+            }
+            suspendedServers[entry.type].push_back(entry.module->getId());
+        } else if (!returnToWarmPool(entry)) {
+            deleteServer(entry);
+        }
+
+        delete msg;
     } else {
         ExecutionManagerModBase::handleMessage(msg);
     }
@@ -62,44 +107,166 @@ void ExecutionManagerMod::handleMessage(cMessage *msg) {
 
 
 void ExecutionManagerMod::doAddServerBootComplete(BootComplete* bootComplete) {
-    cModule *server = getSimulation()->getModule(bootComplete->getModuleId());
-    cModule* loadBalancer = getParentModule()->getSubmodule(
-            LOAD_BALANCER_MODULE_NAME);
+    ServerEntry& entry = servers.at(bootComplete->getModuleId());
+    cModule *server = entry.module;
     cModule* sink = getParentModule()->getSubmodule(SINK_MODULE_NAME);
-    // connect gates
-    loadBalancer->getOrCreateFirstUnconnectedGate("out", 0, false, true)->connectTo(
-            server->gate("in"));
+
+    // connect gates, reusing the ones freed by removed servers
+    int dispatcherGate = allocateGate(dispatcher, "out", freeDispatcherGates);
+    dispatcher->gate("out", dispatcherGate)->connectTo(server->gate("in"));
     server->gate("out")->connectTo(
-            sink->getOrCreateFirstUnconnectedGate("in", 0, false, true));
+            sink->gate("in", allocateGate(sink, "in", freeSinkGates)));
+    check_and_cast<IDispatcher*>(dispatcher)->addRoute(dispatcherGate);
+    entry.state = ACTIVE;
+    if (entry.ramp) {
+        entry.server->startRamp();
+    }
+}
+
+double ExecutionManagerMod::getBootDelay(MTServerType::ServerType serverType, int serverId) {
+    double bootDelay = servers.at(serverId).server->par("bootDelay");
+    if (bootDelay < 0) {
+        return ExecutionManagerModBase::getBootDelay(serverType, serverId);
+    }
+    return bootDelay;
+}
+
+int ExecutionManagerMod::allocateGate(cModule* module, const char* gateName, vector<int>& freeGates) {
+    if (!freeGates.empty()) {
+        int index = freeGates.back();
+        freeGates.pop_back();
+        return index;
+    }
+
+    int index = module->gateSize(gateName);
+    module->setGateSize(gateName, index + 1);
+    return index;
 }
 
 
 ExecutionManagerMod::~ExecutionManagerMod() {
+    for (cMessage* msg : completeRemoveMsgs) {
+        cancelAndDelete(msg);
+    }
 }
 
 
-BootComplete* ExecutionManagerMod::doAddServer(MTServerType::ServerType serverType, bool instantaneous) {
-    // find factory object
-    cModuleType *moduleType = cModuleType::get(getModuleStr(serverType).c_str());
+int ExecutionManagerMod::takeIndex(vector<vector<bool>>& indices, MTServerType::ServerType serverType) {
+    if (serverType >= (int) indices.size()) {
+        indices.resize(serverType + 1);
+    }
 
-    int serverCount = pModel->getConfiguration().getServers(serverType);
+    // use the lowest index not taken (servers being removed still have theirs)
+    vector<bool>& taken = indices[serverType];
+    int index = 1;
+    while (index < (int) taken.size() && taken[index]) {
+        index++;
+    }
+    if (index >= (int) taken.size()) {
+        taken.resize(index + 1, false);
+    }
+    taken[index] = true;
+
+    return index;
+}
+
+string ExecutionManagerMod::getServerName(MTServerType::ServerType serverType, int index, bool pooled) const {
     stringstream name;
-    name << getServerString(serverType);
-    name << serverCount + 1;
-    cModule *module = moduleType->create(name.str().c_str(), getParentModule());
+    name << getServerString(serverType) << (pooled ? "pool" : "") << index;
+    return name.str();
+}
+
+void ExecutionManagerMod::setServerState(ServerEntry& entry, ServerState state) {
+    bool pooled = (entry.state == POOLED);
+    entry.state = state;
+    if (pooled != (state == POOLED)) {
+
+        // pooled servers have their own names, so that they do not take the index of a live server
+        (pooled ? poolIndices : serverIndices)[entry.type][entry.index] = false;
+        entry.index = takeIndex(pooled ? serverIndices : poolIndices, entry.type);
+        entry.module->setName(getServerName(entry.type, entry.index, !pooled).c_str());
+    }
+}
+
+ExecutionManagerMod::ServerEntry& ExecutionManagerMod::createServer(MTServerType::ServerType serverType, ServerState state) {
+    int index = takeIndex((state == POOLED) ? poolIndices : serverIndices, serverType);
+
+    // find factory object
+    cModuleType *moduleType = cModuleType::get(getModuleStr(serverType).c_str());
+    cModule *module = moduleType->create(getServerName(serverType, index, state == POOLED).c_str(), getParentModule());
 
     // setup parameters
     module->finalizeParameters();
     module->buildInside();
 
+    ServerEntry& entry = servers[module->getId()];
+    entry.type = serverType;
+    entry.index = index;
+    entry.module = module;
+    entry.server = check_and_cast<MTBrownoutServer*>(module->getSubmodule(INTERNAL_SERVER_MODULE_NAME));
+    cModule* queue = module->getSubmodule(INTERNAL_QUEUE_MODULE_NAME);
+    entry.queue = queue ? check_and_cast<queueing::PassiveQueue*>(queue) : nullptr;
+    entry.brownoutFactor = &entry.server->par("brownoutFactor");
+    if (brownoutFactor >= 0) {
+        entry.brownoutFactor->setDoubleValue(brownoutFactor);
+    }
+    entry.state = state;
+    entry.ramp = false;
+
+    return entry;
+}
+
+void ExecutionManagerMod::deleteServer(ServerEntry& entry) {
+    ((entry.state == POOLED) ? poolIndices : serverIndices)[entry.type][entry.index] = false;
+    cModule* module = entry.module;
+    servers.erase(module->getId());
+    module->deleteModule();
+}
+
+ExecutionManagerMod::ServerEntry* ExecutionManagerMod::takeFromWarmPool(MTServerType::ServerType serverType) {
+    if (serverType >= (int) warmPools.size() || warmPools[serverType].empty()) {
+        return nullptr;
+    }
+
+    ServerEntry& entry = servers.at(warmPools[serverType].back());
+    warmPools[serverType].pop_back();
+    setServerState(entry, BOOTING);
+
+    return &entry;
+}
+
+bool ExecutionManagerMod::returnToWarmPool(ServerEntry& entry) {
+    if (entry.type >= (int) warmPools.size() || warmPools[entry.type].size() >= warmPoolSize) {
+        return false;
+    }
+
+    // the server was drained, and its cache cleared, so it can be reused as is
+    setServerState(entry, POOLED);
+    warmPools[entry.type].push_back(entry.module->getId());
+
+    return true;
+}
+
+BootComplete* ExecutionManagerMod::doAddServer(MTServerType::ServerType serverType, bool instantaneous) {
+    if (serverType >= (int) serverModuleIds.size()) {
+        serverModuleIds.resize(serverType + 1);
+    }
+    vector<int>& moduleIds = serverModuleIds[serverType];
+
+    // take an idle server from the warm pool if there is one, otherwise build one
+    ServerEntry* entry = takeFromWarmPool(serverType);
+    bool pooled = (entry != nullptr);
+    if (!pooled) {
+        entry = &createServer(serverType, BOOTING);
+    }
+    cModule* module = entry->module;
+    entry->ramp = !instantaneous;
+
     // copy all params of the server inside the appserver module from the template
-    cModule* pNewSubmodule = module->getSubmodule(INTERNAL_SERVER_MODULE_NAME);
-    if (serverCount >= 1) {
+    cModule* pNewSubmodule = entry->server;
+    if (!moduleIds.empty()) {
         // copy from an existing server
-        stringstream templateName;
-        templateName << SERVER_MODULE_NAME;
-        templateName << 1;
-        cModule* pTemplateSubmodule = getParentModule()->getSubmodule(templateName.str().c_str())->getSubmodule(INTERNAL_SERVER_MODULE_NAME);
+        cModule* pTemplateSubmodule = servers.at(moduleIds.front()).server;
 <<<<<<< HEAD
         for (int i = 0; i < pTemplateSubmodule->getNumParams(); i++) {
             pNewSubmodule->par(i) = pTemplateSubmodule->par(i);
@@ -122,6 +289,9 @@ BootComplete* ExecutionManagerMod::doAddServer(MTServerType::ServerType serverTy
         mean = Utils::getMeanAndVarianceFromParameter(pNewSubmodule->par("lowFidelityServiceTime"), &variance);
         pModel->setLowFidelityServiceTime(mean, variance, serverType);
         pModel->setBrownoutFactor(pNewSubmodule->par("brownoutFactor"));
+        mean = Utils::getMeanAndVarianceFromParameter(pNewSubmodule->par("bootDelay"), &variance);
+        pModel->setBootDelay(mean, serverType);
+        pModel->setRamp(pNewSubmodule->par("rampDuration"), pNewSubmodule->par("rampInitialCapacity"), serverType);
 <<<<<<< HEAD
 	int rdWeight = 1 + (rand() % 4);
 	int rdConnection = 1 + (rand() % 9);
@@ -131,9 +301,13 @@ BootComplete* ExecutionManagerMod::doAddServer(MTServerType::ServerType serverTy
 >>>>>>> fc568acc6e702a7b574ac602ba7dad7a5b6cf2db
     }
 
-    // create activation message
-    module->scheduleStart(simTime());
-    module->callInitialize();
+    if (!pooled) {
+
+        // create activation message
+        module->scheduleStart(simTime());
+        module->callInitialize();
+    }
+    moduleIds.push_back(module->getId());
 
     BootComplete* bootComplete = new BootComplete;
     bootComplete->setModuleId(module->getId());
@@ -141,23 +315,7 @@ BootComplete* ExecutionManagerMod::doAddServer(MTServerType::ServerType serverTy
 }
 
 string ExecutionManagerMod::getModuleStr(MTServerType::ServerType serverType) const {
-    string module_str = "";
-
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        module_str = "plasa.modules.AppServerA";
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        module_str = "plasa.modules.AppServerB";
-        break;
-    case MTServerType::ServerType::WEAK:
-        module_str = "plasa.modules.AppServerC";
-        break;
-    case MTServerType::ServerType::NONE:
-        module_str = "";
-    }
-
-    return module_str;
+    return par("appServerModuleType").stdstringValue();
 }
 
 string ExecutionManagerMod::getServerString(MTServerType::ServerType serverType, bool internal) const {
@@ -167,47 +325,49 @@ string ExecutionManagerMod::getServerString(MTServerType::ServerType serverType,
         name_str = INTERNAL_SERVER_MODULE_NAME;
     }
 
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        name_str += string("_A_");
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        name_str += string("_B_");
-        break;
-    case MTServerType::ServerType::WEAK:
-        name_str += string("_C_");
-        break;
-    case MTServerType::ServerType::NONE:
-        name_str = "";
+    if (serverType == MTServerType::ServerType::NONE) {
+        return "";
     }
 
-    return name_str;
+    return name_str + "_" + pModel->getServerTypeName(serverType) + "_";
 }
 
-BootComplete*  ExecutionManagerMod::doRemoveServer(MTServerType::ServerType serverType) {
-    int serverCount = pModel->getConfiguration().getServers(serverType);
-    stringstream name;
-    name << getServerString(serverType);
-    name << serverCount;
-    cModule *module = getParentModule()->getSubmodule(name.str().c_str());
+bool ExecutionManagerMod::hasServer(MTServerType::ServerType serverType, int serverId) const {
+    auto it = servers.find(serverId);
+    return it != servers.end() && it->second.type == serverType
+            && (it->second.state == BOOTING || it->second.state == ACTIVE);
+}
 
-    // disconnect module from load balancer
-    cGate* pInGate = module->gate("in");
-    if (pInGate->isConnected()) {
-        cGate *otherEnd = pInGate->getPathStartGate();
-        otherEnd->disconnect();
-        ASSERT(otherEnd->getIndex() == otherEnd->getVectorSize() - 1);
+MTServerType::ServerType ExecutionManagerMod::getServerType(const cModule* server) const {
+    auto it = servers.find(server->getId());
+    if (it != servers.end()) {
+        return it->second.type;
+    }
+    return ExecutionManagerModBase::getServerType(server);
+}
 
-        // reduce the size of the out gate in the queue module
-        otherEnd->getOwnerModule()->setGateSize(otherEnd->getName(), otherEnd->getVectorSize() - 1);
-        //TODO this is probably leaking memory because the gate may not be being deleted
+BootComplete*  ExecutionManagerMod::doRemoveServer(MTServerType::ServerType serverType, int serverId) {
+    ASSERT(serverType < (int) serverModuleIds.size() && !serverModuleIds[serverType].empty());
+    vector<int>& moduleIds = serverModuleIds[serverType];
+    if (serverId < 0) {
+
+        // remove the server added last, which may still be booting
+        serverId = moduleIds.back();
+        moduleIds.pop_back();
+    } else {
+        vector<int>::iterator it = find(moduleIds.begin(), moduleIds.end(), serverId);
+        ASSERT(it != moduleIds.end());
+        moduleIds.erase(it);
     }
+    ServerEntry& entry = servers.at(serverId);
+    cModule *module = entry.module;
 
-    serverBeingRemovedModuleId = module->getId();
+    disconnectFromDispatcher(entry);
+    entry.state = REMOVING;
 
     // check to see if we can delete the server immediately (or if it's busy)
-    if (isServerBeingRemoveEmpty()) {
-        completeServerRemoval();
+    if (isServerBeingRemoveEmpty(entry)) {
+        completeServerRemoval(entry);
     }
 
     BootComplete* bootComplete = new BootComplete;
@@ -215,54 +375,137 @@ BootComplete*  ExecutionManagerMod::doRemoveServer(MTServerType::ServerType serv
     return bootComplete;
 }
 
+BootComplete* ExecutionManagerMod::doSuspendServer(MTServerType::ServerType serverType, int serverId) {
+    ASSERT(serverType < (int) serverModuleIds.size());
+    vector<int>& moduleIds = serverModuleIds[serverType];
+    vector<int>::iterator it;
+    if (serverId < 0) {
+
+        // suspend the active server added last
+        vector<int>::reverse_iterator rit = find_if(moduleIds.rbegin(), moduleIds.rend(),
+                [this](int id) { return servers.at(id).state == ACTIVE; });
+        ASSERT(rit != moduleIds.rend());
+        it = rit.base() - 1;
+    } else {
+        it = find(moduleIds.begin(), moduleIds.end(), serverId);
+        ASSERT(it != moduleIds.end());
+    }
+    ServerEntry& entry = servers.at(*it);
+    ASSERT(entry.state == ACTIVE);
+    moduleIds.erase(it);
+
+    disconnectFromDispatcher(entry);
+    entry.state = SUSPENDING;
+
+    if (isServerBeingRemoveEmpty(entry)) {
+        completeServerRemoval(entry);
+    }
+
+    BootComplete* bootComplete = new BootComplete;
+    bootComplete->setModuleId(entry.module->getId());
+    return bootComplete;
+}
+
+BootComplete* ExecutionManagerMod::doResumeServer(MTServerType::ServerType serverType) {
+    ASSERT(serverType < (int) suspendedServers.size() && !suspendedServers[serverType].empty());
+
+    // resume the server suspended last, and connect it when the resume completes
+    ServerEntry& entry = servers.at(suspendedServers[serverType].back());
+    suspendedServers[serverType].pop_back();
+    entry.state = BOOTING;
+    entry.ramp = false; // it was kept warm
+    serverModuleIds[serverType].push_back(entry.module->getId());
+
+    BootComplete* bootComplete = new BootComplete;
+    bootComplete->setModuleId(entry.module->getId());
+    return bootComplete;
+}
+
+void ExecutionManagerMod::disconnectFromDispatcher(ServerEntry& entry) {
+    cModule *module = entry.module;
+
+    // disconnect module from the dispatcher, leaving its gate free for the next server
+    cGate* pInGate = module->gate("in");
+    if (pInGate->isConnected()) {
+        cGate *otherEnd = pInGate->getPathStartGate();
+        check_and_cast<IDispatcher*>(otherEnd->getOwnerModule())->removeRoute(otherEnd->getIndex());
+        otherEnd->disconnect();
+        freeDispatcherGates.push_back(otherEnd->getIndex());
+
+        // only the jobs in service have to finish here
+        LoadBalancer* loadBalancer = dynamic_cast<LoadBalancer*>(otherEnd->getOwnerModule());
+        if (migrateQueuedJobs && entry.queue && loadBalancer) {
+            emit(jobsMigratedSignal, (long) migrateQueuedJobsFrom(entry, loadBalancer), module);
+        }
+        emit(serverDrainingSignal, (long) entry.server->getJobsInService(), module);
+    }
+}
+
 void ExecutionManagerMod::doSetBrownout(MTServerType::ServerType serverType, double factor) {
-    int serverCount = pModel->getConfiguration().getServers(serverType);
-    for (int s = 1; s <= serverCount; s++) {
-        stringstream name;
-        name << getServerString(serverType);
-        name << s;
-
-        cModule* module = getParentModule()->getSubmodule(name.str().c_str());
-        module->getSubmodule("server")->par("brownoutFactor").setDoubleValue(factor);
+    if (serverType >= (int) serverModuleIds.size()) {
+        return;
+    }
+    for (int moduleId : serverModuleIds[serverType]) {
+        servers.at(moduleId).brownoutFactor->setDoubleValue(factor);
     }
 }
 
 void ExecutionManagerMod::doSetBrownout(double factor) {
-    doSetBrownout(MTServerType::ServerType::POWERFUL, factor);
-    doSetBrownout(MTServerType::ServerType::AVERAGE, factor);
-    doSetBrownout(MTServerType::ServerType::WEAK, factor);
+    brownoutFactor = factor;
+
+    // all the servers, including pooled ones, so that they are not stale when added
+    for (auto& idAndEntry : servers) {
+        idAndEntry.second.brownoutFactor->setDoubleValue(factor);
+    }
 }
 
 
-void ExecutionManagerMod::completeServerRemoval() {
+void ExecutionManagerMod::completeServerRemoval(ServerEntry& entry) {
     Enter_Method("sendMe()");
 
-    // clear cache for server, so that the next time it is instantiated it is fresh
-    cModule* module = getSimulation()->getModule(serverBeingRemovedModuleId);
-    check_and_cast<MTBrownoutServer*>(module->getSubmodule(INTERNAL_SERVER_MODULE_NAME))->clearServerCache();
+    // no longer waiting for it to be idle
+    if (entry.state == SUSPENDING) {
+
+        // a suspended server keeps its cache, which is the point of suspending it
+        entry.state = SUSPENDED;
+    } else {
+        entry.state = DRAINED;
+
+        // clear cache for server, so that the next time it is instantiated it is fresh
+        entry.server->clearServerCache();
+    }
 
-    completeRemoveMsg = new cMessage("completeRemove");
+    BootComplete* completeRemoveMsg = new BootComplete("completeRemove");
+    completeRemoveMsg->setModuleId(entry.module->getId());
+    completeRemoveMsgs.insert(completeRemoveMsg);
     cout << "scheduled complete remove at " << simTime() << endl;
     scheduleAt(simTime(), completeRemoveMsg);
 }
 
-bool ExecutionManagerMod::isServerBeingRemoveEmpty() {
-    bool isEmpty = false;
-    cModule* module = getSimulation()->getModule(serverBeingRemovedModuleId);
-    MTServer* internalServer = check_and_cast<MTServer*> (module->getSubmodule(INTERNAL_SERVER_MODULE_NAME));
-    if (internalServer->isEmpty()) {
-        queueing::PassiveQueue* queue = check_and_cast<queueing::PassiveQueue*> (module->getSubmodule(INTERNAL_QUEUE_MODULE_NAME));
-        if (queue->length() == 0) {
-            isEmpty = true;
-        }
+unsigned ExecutionManagerMod::migrateQueuedJobsFrom(ServerEntry& entry, LoadBalancer* loadBalancer) {
+    unsigned migrated = 0;
+
+    // if all the servers are being removed, the jobs have nowhere to go
+    while (entry.queue->length() > 0 && loadBalancer->getNumberOfRoutes() > 0) {
+        queueing::Job* job = entry.queue->dequeue();
+        take(job);
+        loadBalancer->reroute(job);
+        migrated++;
     }
-    return isEmpty;
+
+    return migrated;
+}
+
+bool ExecutionManagerMod::isServerBeingRemoveEmpty(const ServerEntry& entry) const {
+    return entry.server->isEmpty() && (!entry.queue || entry.queue->length() == 0);
 }
 
 void ExecutionManagerMod::receiveSignal(cComponent *source, simsignal_t signalID, bool value, cObject *details) {
-    if (signalID == serverBusySignalId && source->getParentModule()->getId() == serverBeingRemovedModuleId) {
-        if (value == false && isServerBeingRemoveEmpty()) {
-            completeServerRemoval();
+    if (signalID == serverBusySignalId && value == false) {
+        auto it = servers.find(source->getParentModule()->getId());
+        if (it != servers.end() && (it->second.state == REMOVING || it->second.state == SUSPENDING)
+                && isServerBeingRemoveEmpty(it->second)) {
+            completeServerRemoval(it->second);
         }
     }
 }
@@ -17,26 +17,161 @@
 
 #include <omnetpp.h>
 #include <set>
+#include <unordered_map>
 #include "BootComplete_m.h"
 #include <model/Model.h>
 #include <string>
+#include <vector>
 #include "ExecutionManagerModBase.h"
 using namespace std;
+class MTBrownoutServer;
+class LoadBalancer;
+namespace queueing { class PassiveQueue; }
+
 class ExecutionManagerMod : public ExecutionManagerModBase, omnetpp::cListener {
     omnetpp::simsignal_t serverBusySignalId;
-    int serverBeingRemovedModuleId;
-    omnetpp::cMessage* completeRemoveMsg;
+    omnetpp::simsignal_t serverDrainingSignal;
+    omnetpp::simsignal_t jobsMigratedSignal;
+
+    enum ServerState {
+        POOLED,   /**< idle in the warm pool */
+        BOOTING,  /**< added, but not connected to the load balancer yet */
+        ACTIVE,   /**< connected to the load balancer */
+        REMOVING, /**< disconnected from the load balancer, and being drained */
+        DRAINED,  /**< drained, and about to be deleted or pooled */
+        SUSPENDING, /**< disconnected from the load balancer, and being drained to be suspended */
+        SUSPENDED /**< drained, and kept with its cache until it is resumed */
+    };
+
+    /**
+     * Entry of the server registry, so that servers do not have to be
+     * looked up by name
+     */
+    struct ServerEntry {
+        MTServerType::ServerType type;
+        int index; /**< index in the module name, server_<type>_<index> or server_<type>_pool<index> */
+        omnetpp::cModule* module;
+        MTBrownoutServer* server; /**< server inside the module */
+        queueing::PassiveQueue* queue; /**< queue inside the module, nullptr if it uses the shared queue */
+        omnetpp::cPar* brownoutFactor; /**< brownoutFactor parameter of the server */
+        ServerState state;
+        bool ramp; /**< if true, its capacity ramps up when it becomes active */
+    };
+
+    /** all the servers this manager created, including pooled ones, indexed by module id */
+    std::unordered_map<int, ServerEntry> servers;
+
+    /** module ids of the servers of each type in the order they were added, indexed by type id */
+    std::vector<std::vector<int>> serverModuleIds;
+
+    /** indices taken by server names, indexed by type id and then index */
+    std::vector<std::vector<bool>> serverIndices;
+
+    /** indices taken by pooled server names, indexed by type id and then index */
+    std::vector<std::vector<bool>> poolIndices;
+
+    /**
+     * Module that sends the requests to the servers, which is the load
+     * balancer, or the shared queue if the network has one
+     */
+    omnetpp::cModule* dispatcher;
+
+    /*
+     * A server keeps the gate indices it was connected to in the
+     * dispatcher and the sink for as long as it lives. When it is removed,
+     * its indices are recycled for the next server instead of shrinking
+     * the gate vectors, so that any server can be removed, not only the
+     * one connected last
+     */
+    std::vector<int> freeDispatcherGates; /**< unconnected indices of the dispatcher out gates */
+    std::vector<int> freeSinkGates; /**< unconnected indices of the sink in gates */
+
+    std::set<omnetpp::cMessage*> completeRemoveMsgs;
+
+    /** module ids of the suspended servers in the order they were suspended, indexed by type id */
+    std::vector<std::vector<int>> suspendedServers;
+
+    /*
+     * Idle servers are kept built and initialized, but disconnected, in a
+     * warm pool per server type, so that adding a server only has to
+     * connect it, and removing it only has to disconnect it
+     */
+    unsigned warmPoolSize; /**< idle servers to keep for each type */
+    std::vector<std::vector<int>> warmPools; /**< module ids of the idle servers, indexed by type id */
+    double brownoutFactor; /**< last brownout factor set, negative if none */
+
+    bool migrateQueuedJobs; /**< if true, removing a server only waits for the jobs in service */
+
+    /**
+     * Routes the jobs queued in a server, which must be disconnected
+     * from the load balancer, to the other servers
+     *
+     * @return number of jobs migrated
+     */
+    unsigned migrateQueuedJobsFrom(ServerEntry& entry, LoadBalancer* loadBalancer);
+
+    /**
+     * Disconnects a server from the dispatcher, leaving its gate free for
+     * the next server, and migrates its queued jobs if enabled
+     */
+    void disconnectFromDispatcher(ServerEntry& entry);
+
+    /**
+     * Takes the lowest free index of a server type
+     */
+    static int takeIndex(std::vector<std::vector<bool>>& indices, MTServerType::ServerType serverType);
+
+    /**
+     * @return server_<type>_<index>, or server_<type>_pool<index> for pooled servers
+     */
+    string getServerName(MTServerType::ServerType serverType, int index, bool pooled) const;
+
+    /**
+     * Moves a server in or out of the warm pool, renaming it accordingly
+     */
+    void setServerState(ServerEntry& entry, ServerState state);
+
+    /**
+     * Creates a server module, builds it, and registers it, but does not
+     * initialize it
+     */
+    ServerEntry& createServer(MTServerType::ServerType serverType, ServerState state);
+
+    /**
+     * Deletes a server module and removes it from the registry
+     */
+    void deleteServer(ServerEntry& entry);
+
+    /**
+     * Takes an idle server from the warm pool
+     *
+     * @return the registry entry of the server, or nullptr if the pool is empty
+     */
+    ServerEntry* takeFromWarmPool(MTServerType::ServerType serverType);
+
+    /**
+     * Puts a removed server in the warm pool
+     *
+     * @return false if the pool is full, in which case the server must be deleted
+     */
+    bool returnToWarmPool(ServerEntry& entry);
 
     /**
      * Sends a message so that when received (immediately) will complete the removal
      * This is used so that the signal handler can do it
      */
-    void completeServerRemoval();
+    void completeServerRemoval(ServerEntry& entry);
+
 
+    bool isServerBeingRemoveEmpty(const ServerEntry& entry) const;
 
-    bool isServerBeingRemoveEmpty();
+    /**
+     * @return a free index in the gate vector, growing it if there is none
+     */
+    static int allocateGate(omnetpp::cModule* module, const char* gateName, std::vector<int>& freeGates);
   protected:
-    virtual void initialize();
+    virtual int numInitStages() const {return 2;}
+    virtual void initialize(int stage);
     virtual void handleMessage(omnetpp::cMessage *msg);
 
     // target-specific methods (e.g., actual servers, sim servers, etc.)
@@ -47,19 +182,32 @@ class ExecutionManagerMod : public ExecutionManagerModBase, omnetpp::cListener {
     virtual BootComplete* doAddServer(MTServerType::ServerType serverType, bool instantaneous = false);
     virtual void doAddServerBootComplete(BootComplete* bootComplete);
 
+    /**
+     * @return a sample of the bootDelay parameter of the server, or of the
+     *   network if the server does not set it
+     */
+    virtual double getBootDelay(MTServerType::ServerType serverType, int serverId);
+
     /**
      * @return BootComplete* identical in content (not the pointer itself) to
      *   what doAddServer() would have return for this server
      */
-    virtual BootComplete* doRemoveServer(MTServerType::ServerType serverType);
+    virtual BootComplete* doRemoveServer(MTServerType::ServerType serverType, int serverId = -1);
+    virtual BootComplete* doSuspendServer(MTServerType::ServerType serverType, int serverId = -1);
+    virtual BootComplete* doResumeServer(MTServerType::ServerType serverType);
     virtual void doSetBrownout(MTServerType::ServerType serverType, double factor);
     virtual void doSetBrownout(double factor);
     virtual string getModuleStr(MTServerType::ServerType serverType) const;
 
   public:
+    static const char* SIG_SERVER_DRAINING;
+    static const char* SIG_JOBS_MIGRATED;
+
     ExecutionManagerMod();
     virtual ~ExecutionManagerMod();
 
+    virtual bool hasServer(MTServerType::ServerType serverType, int serverId) const;
+    virtual MTServerType::ServerType getServerType(const omnetpp::cModule* server) const;
     virtual void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, bool value, cObject *details) override;
     virtual string getServerString(MTServerType::ServerType serverType, bool internal=false) const;
 };
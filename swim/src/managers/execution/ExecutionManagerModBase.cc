@@ -24,9 +24,10 @@ const char* ExecutionManagerModBase::SIG_SERVER_REMOVED = "serverRemoved";
 const char* ExecutionManagerModBase::SIG_SERVER_ADDED = "serverAdded";
 const char* ExecutionManagerModBase::SIG_SERVER_ACTIVATED = "serverActivated";
 const char* ExecutionManagerModBase::SIG_BROWNOUT_SET = "brownoutSet";
+const char* ExecutionManagerModBase::SIG_TRAFFIC_DIVERTED = "trafficDiverted";
 
 
-ExecutionManagerModBase::ExecutionManagerModBase() : serverRemoveInProgress(0), testMsg(0) {
+ExecutionManagerModBase::ExecutionManagerModBase() : testMsg(0) {
 }
 
 void ExecutionManagerModBase::initialize() {
@@ -35,6 +36,7 @@ void ExecutionManagerModBase::initialize() {
     serverAddedSignal = registerSignal(SIG_SERVER_ADDED);
     serverActivatedSignal = registerSignal(SIG_SERVER_ACTIVATED);
     brownoutSetSignal = registerSignal(SIG_BROWNOUT_SET);
+    trafficDivertedSignal = registerSignal(SIG_TRAFFIC_DIVERTED);
 //    testMsg = new cMessage;
 //    testMsg->setKind(0);
 //    scheduleAt(simTime() + 1, testMsg);
@@ -56,10 +58,10 @@ void ExecutionManagerModBase::handleMessage(cMessage* msg) {
     doAddServerBootComplete(bootComplete);
 
     //  notify add complete to model
-    cModule *server = omnetpp::getSimulation()->getModule(bootComplete->getModuleId());
-    MTServerType::ServerType serverType = getServerTypeFromName(server->getFullName());
-    pModel->serverBecameActive(serverType);
-    emit(serverActivatedSignal, true);
+    cModule *server = getServerModule(bootComplete->getModuleId());
+    MTServerType::ServerType serverType = MTServerType::ServerType(bootComplete->getServerType());
+    pModel->serverBecameActive(serverType, bootComplete->getModuleId());
+    emit(serverActivatedSignal, true, server);
 
     cout << "t=" << simTime() << " addServer() complete" << endl;
 
@@ -85,50 +87,141 @@ void ExecutionManagerModBase::addServer(MTServerType::ServerType serverType) {
 void ExecutionManagerModBase::addServerLatencyOptional(MTServerType::ServerType serverType, bool instantaneous) {
     Enter_Method("addServer()");
     int serverCount = pModel->getConfiguration().getServers(serverType);
-    ASSERT(serverCount < pModel->getConfiguration().getMaxServers(serverType));
+    ASSERT(serverCount < pModel->getMaxServers(serverType));
 
     BootComplete* bootComplete = doAddServer(serverType, instantaneous);
+    bootComplete->setServerType(serverType);
 
     double bootDelay = 0;
     if (!instantaneous) {
-        bootDelay = omnetpp::getSimulation()->getSystemModule()->par("bootDelay");
+        bootDelay = getBootDelay(serverType, bootComplete->getModuleId());
         cout << "adding server with latency=" << bootDelay << endl;
     }
 
-    pModel->addServer(bootDelay, serverType);
+    // servers added at the start are already up to speed
+    pModel->addServer(bootDelay, serverType, bootComplete->getModuleId(), !instantaneous);
     //TODO: try to put true
     emit(serverAddedSignal, serverType);
 
+    scheduleBootComplete(bootComplete, bootDelay);
+}
+
+cModule* ExecutionManagerModBase::getServerModule(int serverId) const {
+    return omnetpp::getSimulation()->getModule(serverId);
+}
+
+double ExecutionManagerModBase::getBootDelay(MTServerType::ServerType serverType, int serverId) {
+    return omnetpp::getSimulation()->getSystemModule()->par("bootDelay");
+}
+
+void ExecutionManagerModBase::scheduleBootComplete(BootComplete* bootComplete, double delay) {
     pendingMessages.insert(bootComplete);
-    if (bootDelay == 0) {
+    if (delay == 0) {
         handleMessage(bootComplete);
     } else {
-        scheduleAt(simTime() + bootDelay, bootComplete);
+        scheduleAt(simTime() + delay, bootComplete);
     }
 }
 
 void ExecutionManagerModBase::removeServer(MTServerType::ServerType serverType) {
+    removeServer(serverType, -1);
+}
+
+void ExecutionManagerModBase::removeServer(MTServerType::ServerType serverType, int serverId) {
     Enter_Method("removeServer()");
     cout << "t=" << simTime() << " executing removeServer()" << endl;
-    int serverCount = pModel->getConfiguration().getServers(serverType);
-    ASSERT(pModel->getConfiguration().getTotalActiveServers() > 1);
 
-    ASSERT(serverRemoveInProgress == 0); // removing a server while another is being removed not supported yet
+    // servers being drained are still active, but will not be for long
+    ASSERT(pModel->getConfiguration().getTotalActiveServers() - pModel->getTotalDrainingServers() > 1);
+    ASSERT(pModel->getConfiguration().getServers(serverType) > pModel->getDrainingServers(serverType));
 
-    serverRemoveInProgress++;
-    BootComplete* pBootComplete = doRemoveServer(serverType);
+    BootComplete* pBootComplete = doRemoveServer(serverType, serverId);
 
     // cancel boot complete event if needed
+    bool booting = false;
     for (BootCompletes::iterator it = pendingMessages.begin(); it != pendingMessages.end(); ++it) {
         if ((*it)->getModuleId() == pBootComplete->getModuleId()) {
             cancelAndDelete(*it);
             pendingMessages.erase(it);
+            booting = true;
             break;
         }
     }
+
+    // a booting server leaves the model now, an active one when it has been drained
+    if (booting) {
+        pModel->cancelServerBoot(serverType, pBootComplete->getModuleId());
+    } else {
+        pModel->serverDraining(serverType);
+    }
+    serversBeingRemoved[pBootComplete->getModuleId()] = booting;
     delete pBootComplete;
 }
 
+void ExecutionManagerModBase::addServers(MTServerType::ServerType serverType, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        addServer(serverType);
+    }
+}
+
+void ExecutionManagerModBase::removeServers(MTServerType::ServerType serverType, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        removeServer(serverType);
+    }
+}
+
+void ExecutionManagerModBase::suspendServer(MTServerType::ServerType serverType) {
+    Enter_Method("suspendServer()");
+    cout << "t=" << simTime() << " executing suspendServer()" << endl;
+    ASSERT(pModel->getConfiguration().getTotalActiveServers() - pModel->getTotalDrainingServers() > 1);
+    ASSERT(pModel->getConfiguration().getActiveServers(serverType) > pModel->getDrainingServers(serverType));
+
+    // the server is still active until it has been drained
+    BootComplete* pBootComplete = doSuspendServer(serverType);
+    pModel->serverDraining(serverType);
+    delete pBootComplete;
+}
+
+void ExecutionManagerModBase::suspendServers(MTServerType::ServerType serverType, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        suspendServer(serverType);
+    }
+}
+
+void ExecutionManagerModBase::resumeServer(MTServerType::ServerType serverType) {
+    Enter_Method("resumeServer()");
+    cout << "t=" << simTime() << " executing resumeServer()" << endl;
+    ASSERT(pModel->getSuspendedServers(serverType) > 0);
+    ASSERT(pModel->getConfiguration().getServers(serverType) < pModel->getMaxServers(serverType));
+
+    BootComplete* bootComplete = doResumeServer(serverType);
+    bootComplete->setServerType(serverType);
+
+    double resumeDelay = omnetpp::getSimulation()->getSystemModule()->par("resumeDelay");
+    cout << "resuming server with latency=" << resumeDelay << endl;
+
+    pModel->resumeServer(resumeDelay, serverType, bootComplete->getModuleId());
+    emit(serverAddedSignal, serverType);
+
+    scheduleBootComplete(bootComplete, resumeDelay);
+}
+
+void ExecutionManagerModBase::resumeServers(MTServerType::ServerType serverType, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        resumeServer(serverType);
+    }
+}
+
+BootComplete* ExecutionManagerModBase::doSuspendServer(MTServerType::ServerType serverType, int serverId) {
+    error("suspending servers is not supported by %s", getClassName());
+    return nullptr;
+}
+
+BootComplete* ExecutionManagerModBase::doResumeServer(MTServerType::ServerType serverType) {
+    error("resuming servers is not supported by %s", getClassName());
+    return nullptr;
+}
+
 void ExecutionManagerModBase::setBrownout(double factor) {
     Enter_Method("setBrownout()");
     cout << "t=" << simTime() << " executing setDimmer(" << 1.0 - factor << ")" << endl;
@@ -137,19 +230,35 @@ void ExecutionManagerModBase::setBrownout(double factor) {
     emit(brownoutSetSignal, true);
 }
 
-void ExecutionManagerModBase::notifyRemoveServerCompleted(MTServerType::ServerType serverType) {
+void ExecutionManagerModBase::notifyRemoveServerCompleted(MTServerType::ServerType serverType, cModule* server) {
+    notifyRemoveServerCompleted(serverType, server ? server->getId() : -1, server);
+}
+
+void ExecutionManagerModBase::notifyRemoveServerCompleted(MTServerType::ServerType serverType, int serverId, cModule* server) {
+    bool booting = false;
+    auto it = serversBeingRemoved.find(serverId);
+    if (it != serversBeingRemoved.end()) {
+        booting = it->second;
+        serversBeingRemoved.erase(it);
+    }
 
-    pModel->removeServer(serverType);
-    serverRemoveInProgress--;
+    if (!booting) {
+        pModel->removeServer(serverType, serverId);
+    }
 
     // emit signal to notify others (notably iProbe)
-    emit(serverRemovedSignal, serverType);
+    emit(serverRemovedSignal, (long) serverType, server);
+}
+
+void ExecutionManagerModBase::notifySuspendServerCompleted(MTServerType::ServerType serverType, cModule* server) {
+    pModel->serverSuspended(serverType, server->getId());
+    emit(serverRemovedSignal, (long) serverType, server);
 }
 
-void ExecutionManagerModBase::divertTraffic(LoadBalancer::TrafficLoad serverA,
-        LoadBalancer::TrafficLoad serverB, LoadBalancer::TrafficLoad serverC) {
+void ExecutionManagerModBase::divertTraffic(const std::vector<LoadBalancer::TrafficLoad>& traffic) {
     Enter_Method("divertTraffic()");
-    pModel->setTrafficLoad(serverA, serverB, serverC);
+    pModel->setTrafficLoad(traffic);
+    emit(trafficDivertedSignal, true);
 }
 
 double ExecutionManagerModBase::getMeanAndVarianceFromParameter(const cPar& par, double& variance) const {
@@ -183,17 +292,20 @@ double ExecutionManagerModBase::getMeanAndVarianceFromParameter(const cPar& par,
 }
 
 MTServerType::ServerType ExecutionManagerModBase::getServerTypeFromName(const char* name) const {
+    static const string prefix = "server_";
     MTServerType::ServerType serverType = MTServerType::NONE;
 
-    if (strncmp(name, "server_A_", 9) == 0) {
-        serverType = MTServerType::POWERFUL;
-    } else if (strncmp(name, "server_B_", 9) == 0) {
-        serverType = MTServerType::AVERAGE;
-    } else if (strncmp(name, "server_C_", 9) == 0) {
-        serverType = MTServerType::WEAK;
-    } else {
-        assert(false);
+    string moduleName(name);
+    size_t typeEnd = moduleName.rfind('_');
+    if (moduleName.compare(0, prefix.length(), prefix) == 0
+            && typeEnd != string::npos && typeEnd > prefix.length()) {
+        serverType = pModel->getServerType(moduleName.substr(prefix.length(), typeEnd - prefix.length()));
     }
+    assert(serverType != MTServerType::NONE);
 
     return serverType;
 }
+
+MTServerType::ServerType ExecutionManagerModBase::getServerType(const cModule* server) const {
+    return getServerTypeFromName(server->getFullName());
+}
@@ -17,6 +17,7 @@
 
 #include <omnetpp.h>
 #include <set>
+#include <map>
 #include "BootComplete_m.h"
 #include <model/Model.h>
 #include "ExecutionManager.h"
@@ -24,11 +25,14 @@
 #include "assert.h"
 
 class ExecutionManagerModBase : public omnetpp::cSimpleModule, public ExecutionManager {
-    int serverRemoveInProgress;
+
+    /** servers being removed indexed by module id, true if the server was still booting */
+    std::map<int, bool> serversBeingRemoved;
     omnetpp::simsignal_t serverRemovedSignal;
     omnetpp::simsignal_t serverAddedSignal;
     omnetpp::simsignal_t serverActivatedSignal;
     omnetpp::simsignal_t brownoutSetSignal;
+    omnetpp::simsignal_t trafficDivertedSignal;
 
   protected:
     typedef std::set<BootComplete*> BootCompletes;
@@ -47,9 +51,33 @@ class ExecutionManagerModBase : public omnetpp::cSimpleModule, public ExecutionM
      * doRemoveServer() can disconnect the server from the load balancer
      * and when all requests in the server have been processed, call this method,
      * so that the server is removed from the model
-     * TODO there should be a state in the model to mark servers being shutdown
+     * Any number of removals can be in progress at the same time. The
+     * implementation must not call this from doRemoveServer()
+     *
+     * @param server the server module, passed as details of the signal so
+     *   that listeners do not have to look it up by name
+     */
+    void notifyRemoveServerCompleted(MTServerType::ServerType serverType, omnetpp::cModule* server = nullptr);
+
+    /**
+     * Like notifyRemoveServerCompleted(), for servers that are not
+     * modules, identified by the id in their BootComplete
+     */
+    void notifyRemoveServerCompleted(MTServerType::ServerType serverType, int serverId, omnetpp::cModule* server = nullptr);
+
+    /**
+     * When a suspend server completes, the implementation must call this function
+     *
+     * Like notifyRemoveServerCompleted(), but the server is kept so that it
+     * can be resumed. For the listeners of the signals, it has left the
+     * system as if it had been removed
      */
-    void notifyRemoveServerCompleted(MTServerType::ServerType serverType);
+    void notifySuspendServerCompleted(MTServerType::ServerType serverType, omnetpp::cModule* server);
+
+    /**
+     * Handles bootComplete after delay seconds, or right away if delay is 0
+     */
+    void scheduleBootComplete(BootComplete* bootComplete, double delay);
 
     double getMeanAndVarianceFromParameter(const cPar& par, double& variance) const;
 
@@ -61,23 +89,67 @@ class ExecutionManagerModBase : public omnetpp::cSimpleModule, public ExecutionM
      */
     virtual BootComplete* doAddServer(MTServerType::ServerType serverType, bool instantaneous = false) = 0;
     virtual void doAddServerBootComplete(BootComplete* bootComplete) = 0;
-    virtual MTServerType::ServerType getServerTypeFromName(const char* name) const;
 
     /**
+     * @param serverId id of the server in its BootComplete
+     * @return the module of the server, passed as details of the signals,
+     *   or nullptr if servers are not modules. By default, the module
+     *   with that id
+     */
+    virtual omnetpp::cModule* getServerModule(int serverId) const;
+
+    /**
+     * @param serverId module id of the server being added
+     * @return the time it takes the server to boot. By default, a sample
+     *   of the bootDelay parameter of the network
+     */
+    virtual double getBootDelay(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * @param serverId module id of the server to remove, or -1 to let the
+     *   implementation choose one
      * @return BootComplete* identical in content (not the pointer itself) to
      *   what doAddServer() would have returned for this server
      */
-    virtual BootComplete* doRemoveServer(MTServerType::ServerType serverType) = 0;
+    virtual BootComplete* doRemoveServer(MTServerType::ServerType serverType, int serverId = -1) = 0;
     virtual void doSetBrownout(double factor) = 0;
 
+    /**
+     * Disconnects an active server, which keeps its state (e.g., its cache)
+     * once drained. When drained, the implementation must call
+     * notifySuspendServerCompleted()
+     *
+     * @param serverId module id of the server to suspend, or -1 to let the
+     *   implementation choose one
+     * @return BootComplete* with the module id of the server
+     */
+    virtual BootComplete* doSuspendServer(MTServerType::ServerType serverType, int serverId = -1);
+
+    /**
+     * @return BootComplete* to be handled later by doAddServerBootComplete()
+     */
+    virtual BootComplete* doResumeServer(MTServerType::ServerType serverType);
+
   public:
     static const char* SIG_SERVER_REMOVED;
     static const char* SIG_SERVER_ADDED;
     static const char* SIG_SERVER_ACTIVATED;
     static const char* SIG_BROWNOUT_SET;
+    static const char* SIG_TRAFFIC_DIVERTED;
 
     ExecutionManagerModBase();
     virtual ~ExecutionManagerModBase();
+
+    /**
+     * Gets the type of a server from the name of its module, which is
+     * server_<type name>_<index>
+     */
+    virtual MTServerType::ServerType getServerTypeFromName(const char* name) const;
+
+    /**
+     * @return the type of a server module
+     */
+    virtual MTServerType::ServerType getServerType(const omnetpp::cModule* server) const;
     virtual void addServerLatencyOptional(MTServerType::ServerType serverType, bool instantaneous = false);
 
     virtual void addServer() {assert(false);} 
@@ -86,8 +158,50 @@ class ExecutionManagerModBase : public omnetpp::cSimpleModule, public ExecutionM
     // ExecutionManager interface
     virtual void addServer(MTServerType::ServerType serverType);
     virtual void removeServer(MTServerType::ServerType serverType);
+
+    /**
+     * Removes a specific server instead of the one added last
+     *
+     * @param serverId module id of the server, which must be one for which
+     *   hasServer() is true
+     */
+    virtual void removeServer(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * @return true if the server is of that type and is booting or active
+     *   (i.e., not being removed)
+     */
+    virtual bool hasServer(MTServerType::ServerType serverType, int serverId) const = 0;
+
+    /**
+     * Adds several servers of a type at once. They boot concurrently
+     */
+    virtual void addServers(MTServerType::ServerType serverType, unsigned count);
+
+    /**
+     * Removes several servers of a type at once, the ones added last first
+     */
+    virtual void removeServers(MTServerType::ServerType serverType, unsigned count);
+
+    /**
+     * Suspends an active server, the one added last. It stops getting
+     * requests, and once drained it is no longer active, but it keeps its
+     * cache warm so that resuming it is faster than booting a new one
+     */
+    virtual void suspendServer(MTServerType::ServerType serverType);
+    virtual void suspendServers(MTServerType::ServerType serverType, unsigned count);
+
+    /**
+     * Resumes a suspended server, which becomes active after resumeDelay
+     */
+    virtual void resumeServer(MTServerType::ServerType serverType);
+    virtual void resumeServers(MTServerType::ServerType serverType, unsigned count);
     virtual void setBrownout(double factor);
-    virtual void divertTraffic(LoadBalancer::TrafficLoad serverA, LoadBalancer::TrafficLoad serverB, LoadBalancer::TrafficLoad serverC);
+
+    /**
+     * @param traffic traffic load indexed by server type id
+     */
+    virtual void divertTraffic(const std::vector<LoadBalancer::TrafficLoad>& traffic);
 };
 
 #endif /* EXECUTIONMANAGERMODBASE_H_ */
@@ -15,12 +15,24 @@
 
 #include "RemoveServerTactic.h"
 
+RemoveServerTactic::RemoveServerTactic(MTServerType::ServerType serverType, unsigned count)
+    : serverType(serverType), count(count) {}
+
 void RemoveServerTactic::execute(ExecutionManager* execMgr) {
-    execMgr->removeServer();
+    if (serverType == MTServerType::NONE) {
+        for (unsigned i = 0; i < count; i++) {
+            execMgr->removeServer();
+        }
+    } else {
+        execMgr->removeServers(serverType, count);
+    }
 }
 
 void RemoveServerTactic::printOn(std::ostream& os) const {
     os << "RemoveServer";
+    if (serverType != MTServerType::NONE || count != 1) {
+        os << "(" << serverType << ", " << count << ")";
+    }
 }
 
 RemoveServerTactic::~RemoveServerTactic() {
@@ -17,9 +17,18 @@
 #define REMOVESERVERTACTIC_H_
 
 #include "Tactic.h"
+#include <modules/MTServerType.h>
 
 class RemoveServerTactic: public Tactic {
+    MTServerType::ServerType serverType;
+    unsigned count;
 public:
+
+    /**
+     * @param serverType type of the servers to remove, NONE for the default
+     * @param count number of servers to remove, which are drained concurrently
+     */
+    RemoveServerTactic(MTServerType::ServerType serverType = MTServerType::NONE, unsigned count = 1);
     virtual void execute(ExecutionManager* execMgr);
     virtual void printOn(std::ostream& os) const;
     virtual ~RemoveServerTactic();
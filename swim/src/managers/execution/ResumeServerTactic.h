@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef RESUMESERVERTACTIC_H_
+#define RESUMESERVERTACTIC_H_
+
+#include "Tactic.h"
+#include <modules/MTServerType.h>
+
+/**
+ * Resumes servers suspended with SuspendServerTactic
+ */
+class ResumeServerTactic: public Tactic {
+    MTServerType::ServerType serverType;
+    unsigned count;
+public:
+
+    /**
+     * @param serverType type of the servers to resume
+     * @param count number of servers to resume, which resume concurrently
+     */
+    ResumeServerTactic(MTServerType::ServerType serverType, unsigned count = 1);
+    virtual void execute(ExecutionManager* execMgr);
+    virtual void printOn(std::ostream& os) const;
+    virtual ~ResumeServerTactic();
+};
+
+#endif /* RESUMESERVERTACTIC_H_ */
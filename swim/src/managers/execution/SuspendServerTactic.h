@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef SUSPENDSERVERTACTIC_H_
+#define SUSPENDSERVERTACTIC_H_
+
+#include "Tactic.h"
+#include <modules/MTServerType.h>
+
+/**
+ * Suspends servers, which stop getting requests but keep their cache, so
+ * that they can be brought back with ResumeServerTactic faster than with
+ * a cold boot
+ */
+class SuspendServerTactic: public Tactic {
+    MTServerType::ServerType serverType;
+    unsigned count;
+public:
+
+    /**
+     * @param serverType type of the servers to suspend
+     * @param count number of servers to suspend, which are drained concurrently
+     */
+    SuspendServerTactic(MTServerType::ServerType serverType, unsigned count = 1);
+    virtual void execute(ExecutionManager* execMgr);
+    virtual void printOn(std::ostream& os) const;
+    virtual ~SuspendServerTactic();
+};
+
+#endif /* SUSPENDSERVERTACTIC_H_ */
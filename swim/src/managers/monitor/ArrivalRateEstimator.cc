@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#include "ArrivalRateEstimator.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace omnetpp;
+
+ArrivalRateEstimator::~ArrivalRateEstimator() {
+}
+
+ArrivalRateEstimator* ArrivalRateEstimator::create(const char* name, cComponent* owner) {
+    ArrivalRateEstimator* estimator = nullptr;
+
+    if (strcmp(name, "ewma") == 0) {
+        estimator = new EwmaArrivalRateEstimator(owner);
+    } else if (strcmp(name, "kalman") == 0) {
+        estimator = new KalmanArrivalRateEstimator(owner);
+    } else if (strcmp(name, "holtWinters") == 0) {
+        estimator = new HoltWintersArrivalRateEstimator(owner);
+    }
+
+    return estimator;
+}
+
+
+EwmaArrivalRateEstimator::EwmaArrivalRateEstimator(cComponent* owner) {
+    alpha = owner->par("estimatorAlpha");
+}
+
+void EwmaArrivalRateEstimator::update(double measuredRate, double variance, double interval) {
+    if (!initialized) {
+        rate = measuredRate;
+        initialized = true;
+    } else {
+        rate += alpha * (measuredRate - rate);
+    }
+}
+
+double EwmaArrivalRateEstimator::getRate() const {
+    return rate;
+}
+
+double EwmaArrivalRateEstimator::getForecast(double horizon) const {
+    return rate;
+}
+
+
+KalmanArrivalRateEstimator::KalmanArrivalRateEstimator(cComponent* owner) {
+    processNoise = owner->par("estimatorProcessNoise");
+}
+
+void KalmanArrivalRateEstimator::update(double measuredRate, double variance, double interval) {
+    if (!initialized) {
+        rate = measuredRate;
+        trend = 0;
+        p00 = variance;
+        p01 = 0;
+        p11 = processNoise;
+        initialized = true;
+        return;
+    }
+
+    // predict: x = F x, P = F P F' + Q, with F = [1 dt; 0 1]
+    double dt = interval;
+    rate += trend * dt;
+    double n00 = p00 + dt * (2 * p01 + dt * p11) + processNoise * dt * dt * dt / 3;
+    double n01 = p01 + dt * p11 + processNoise * dt * dt / 2;
+    double n11 = p11 + processNoise * dt;
+
+    // update with the measurement of the rate (H = [1 0])
+    double s = n00 + variance;
+    if (s <= 0) {
+        return;
+    }
+    double k0 = n00 / s;
+    double k1 = n01 / s;
+    double innovation = measuredRate - rate;
+    rate += k0 * innovation;
+    trend += k1 * innovation;
+    p00 = (1 - k0) * n00;
+    p01 = (1 - k0) * n01;
+    p11 = n11 - k1 * n01;
+}
+
+double KalmanArrivalRateEstimator::getRate() const {
+    return rate;
+}
+
+double KalmanArrivalRateEstimator::getForecast(double horizon) const {
+    return rate + trend * horizon;
+}
+
+
+HoltWintersArrivalRateEstimator::HoltWintersArrivalRateEstimator(cComponent* owner)
+    : HoltWintersArrivalRateEstimator(owner->par("estimatorAlpha"),
+            owner->par("estimatorBeta"), owner->par("estimatorGamma"),
+            std::max(0, (int) owner->par("estimatorSeasonLength"))) {
+}
+
+HoltWintersArrivalRateEstimator::HoltWintersArrivalRateEstimator(double alpha,
+        double beta, double gamma, unsigned seasonLength)
+    : alpha(alpha), beta(beta), gamma(gamma), season(seasonLength, 0.0) {
+}
+
+void HoltWintersArrivalRateEstimator::update(double measuredRate, double variance, double updateInterval) {
+    interval = updateInterval;
+    if (updates == 0 && season.empty()) {
+        level = measuredRate;
+        trend = 0;
+    } else if (updates < season.size()) {
+
+        /*
+         * during the first season the level is the mean of the season, and
+         * the initial seasonal components are the deviations from it
+         */
+        season[seasonIndex] = measuredRate;
+        level += (measuredRate - level) / (updates + 1);
+        trend = 0;
+        if (updates + 1 == season.size()) {
+            for (auto& seasonal : season) {
+                seasonal -= level;
+            }
+        }
+    } else {
+        double seasonal = getSeasonal(0);
+        double lastLevel = level;
+        level = alpha * (measuredRate - seasonal) + (1 - alpha) * (level + trend);
+        trend = beta * (level - lastLevel) + (1 - beta) * trend;
+        if (!season.empty()) {
+            season[seasonIndex] = gamma * (measuredRate - level) + (1 - gamma) * seasonal;
+        }
+    }
+    if (!season.empty()) {
+        seasonIndex = (seasonIndex + 1) % season.size();
+    }
+    updates++;
+}
+
+double HoltWintersArrivalRateEstimator::getRate() const {
+
+    // seasonal component of the last update, once there are seasonal components
+    return level + ((hasSeasonalComponents()) ? getSeasonal(season.size() - 1) : 0);
+}
+
+double HoltWintersArrivalRateEstimator::getForecast(double horizon) const {
+    unsigned steps = (interval > 0) ? (unsigned) std::round(horizon / interval) : 0;
+    return getForecast(steps);
+}
+
+double HoltWintersArrivalRateEstimator::getForecast(unsigned steps) const {
+    if (steps == 0) {
+        return getRate();
+    }
+    return level + steps * trend + getSeasonal(steps - 1);
+}
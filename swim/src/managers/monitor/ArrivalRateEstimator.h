@@ -0,0 +1,135 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#ifndef ARRIVALRATEESTIMATOR_H_
+#define ARRIVALRATEESTIMATOR_H_
+
+#include <omnetpp.h>
+#include <vector>
+
+/**
+ * Online estimator of the arrival rate, updated with the (noisy) rate
+ * measured by the probe at every oversampling tick
+ *
+ * Implementations keep O(1) state (O(season length) for Holt-Winters)
+ * and take O(1) time per update.
+ */
+class ArrivalRateEstimator {
+public:
+    virtual ~ArrivalRateEstimator();
+
+    /**
+     * Updates the estimate with a new measurement
+     *
+     * @param rate measured arrival rate (requests/s)
+     * @param variance variance of the measurement ((requests/s)^2)
+     * @param interval time since the previous update (s)
+     */
+    virtual void update(double rate, double variance, double interval) = 0;
+
+    /**
+     * @return the smoothed arrival rate (requests/s)
+     */
+    virtual double getRate() const = 0;
+
+    /**
+     * @param horizon time ahead (s)
+     * @return the arrival rate forecast for the given time ahead (requests/s)
+     */
+    virtual double getForecast(double horizon) const = 0;
+
+    /**
+     * Creates an estimator, taking its parameters from the owner module
+     *
+     * @param name ewma, kalman or holtWinters
+     * @return the estimator, or nullptr if the name is not known
+     */
+    static ArrivalRateEstimator* create(const char* name, omnetpp::cComponent* owner);
+};
+
+/**
+ * Exponentially weighted moving average of the rate (no trend)
+ */
+class EwmaArrivalRateEstimator : public ArrivalRateEstimator {
+protected:
+    double alpha;
+    double rate = 0;
+    bool initialized = false;
+public:
+    EwmaArrivalRateEstimator(omnetpp::cComponent* owner);
+    virtual void update(double rate, double variance, double interval);
+    virtual double getRate() const;
+    virtual double getForecast(double horizon) const;
+};
+
+/**
+ * Kalman filter with a local linear trend model (state: rate and its
+ * trend), with the process noise modeled as a random acceleration of the
+ * rate, and the measurement noise given by the variance of the measurement
+ */
+class KalmanArrivalRateEstimator : public ArrivalRateEstimator {
+protected:
+    double processNoise; /**< variance of the random acceleration per second */
+    double rate = 0;
+    double trend = 0; /**< requests/s per second */
+    double p00 = 0, p01 = 0, p11 = 0; /**< covariance of the estimate */
+    bool initialized = false;
+public:
+    KalmanArrivalRateEstimator(omnetpp::cComponent* owner);
+    virtual void update(double rate, double variance, double interval);
+    virtual double getRate() const;
+    virtual double getForecast(double horizon) const;
+};
+
+/**
+ * Additive Holt-Winters (triple exponential smoothing). With a season
+ * length of 0 it is Holt's linear trend method
+ */
+class HoltWintersArrivalRateEstimator : public ArrivalRateEstimator {
+protected:
+    double alpha; /**< level smoothing */
+    double beta; /**< trend smoothing */
+    double gamma; /**< seasonal smoothing */
+    double level = 0;
+    double trend = 0; /**< per update */
+    double interval = 0; /**< time between updates, to scale the forecast */
+    std::vector<double> season; /**< seasonal components, one per update in a season */
+    unsigned seasonIndex = 0; /**< index of the seasonal component for the next update */
+    unsigned updates = 0;
+
+    /**
+     * During the first season, season[] holds the measured rates, not
+     * seasonal components, so they must not be added to the level
+     */
+    inline bool hasSeasonalComponents() const {
+        return !season.empty() && updates >= season.size();
+    }
+
+    inline double getSeasonal(unsigned stepsAhead) const {
+        return (hasSeasonalComponents()) ? season[(seasonIndex + stepsAhead) % season.size()] : 0;
+    }
+public:
+    HoltWintersArrivalRateEstimator(omnetpp::cComponent* owner);
+    HoltWintersArrivalRateEstimator(double alpha, double beta, double gamma, unsigned seasonLength);
+    virtual void update(double rate, double variance, double interval);
+    virtual double getRate() const;
+    virtual double getForecast(double horizon) const;
+
+    /**
+     * @return the forecast for a number of updates ahead
+     */
+    double getForecast(unsigned steps) const;
+};
+
+#endif /* ARRIVALRATEESTIMATOR_H_ */
@@ -0,0 +1,192 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#include "ArrivalRateForecaster.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+using namespace omnetpp;
+
+ArrivalRateForecaster::ArrivalRateForecaster(unsigned historySize)
+    : history(max(1u, historySize), 0.0) {
+}
+
+ArrivalRateForecaster::~ArrivalRateForecaster() {
+}
+
+void ArrivalRateForecaster::addObservation(double rate) {
+    if (count < history.size()) {
+        count++;
+    } else {
+        head = (head + 1) % history.size();
+    }
+    history[(head + count - 1) % history.size()] = rate;
+}
+
+ArrivalRateForecaster* ArrivalRateForecaster::create(const char* name, cComponent* owner) {
+    ArrivalRateForecaster* forecaster = nullptr;
+
+    if (strcmp(name, "seasonalNaive") == 0) {
+        forecaster = new SeasonalNaiveArrivalRateForecaster(owner);
+    } else if (strcmp(name, "holtWinters") == 0) {
+        forecaster = new HoltWintersArrivalRateForecaster(owner);
+    } else if (strcmp(name, "ar") == 0) {
+        forecaster = new ARArrivalRateForecaster(owner);
+    }
+
+    return forecaster;
+}
+
+
+SeasonalNaiveArrivalRateForecaster::SeasonalNaiveArrivalRateForecaster(cComponent* owner)
+    : ArrivalRateForecaster((int) owner->par("forecastHistory")) {
+    seasonLength = max(1, (int) owner->par("forecastSeasonLength"));
+}
+
+void SeasonalNaiveArrivalRateForecaster::forecast(unsigned steps, Predictions& predictions) {
+    predictions.clear();
+    if (count == 0) {
+        predictions.assign(steps, Prediction { 0, 0 });
+        return;
+    }
+    unsigned season = (count >= seasonLength) ? seasonLength : 1;
+
+    // standard deviation of the seasonal differences in the history
+    double sum = 0;
+    double sumSquares = 0;
+    unsigned n = 0;
+    for (size_t lag = 0; lag + season < count; lag++) {
+        double diff = getLagged(lag) - getLagged(lag + season);
+        sum += diff;
+        sumSquares += diff * diff;
+        n++;
+    }
+    double stdDev = (n > 1) ? sqrt(max(0.0, (sumSquares - sum * sum / n) / (n - 1))) : 0;
+
+    for (unsigned k = 1; k <= steps; k++) {
+        unsigned seasonsAhead = (k - 1) / season + 1;
+        double rate = getLagged(season - 1 - (k - 1) % season);
+        predictions.push_back(Prediction { rate, stdDev * sqrt(seasonsAhead) });
+    }
+}
+
+
+HoltWintersArrivalRateForecaster::HoltWintersArrivalRateForecaster(cComponent* owner)
+    : ArrivalRateForecaster((int) owner->par("forecastHistory")),
+      estimator(owner->par("forecastAlpha"), owner->par("forecastBeta"),
+              owner->par("forecastGamma"), max(0, (int) owner->par("forecastSeasonLength"))) {
+    alpha = owner->par("forecastAlpha");
+}
+
+void HoltWintersArrivalRateForecaster::addObservation(double rate) {
+    if (count > 0) {
+        double error = rate - lastForecast;
+        squaredError = (count == 1) ? error * error : alpha * error * error + (1 - alpha) * squaredError;
+    }
+    ArrivalRateForecaster::addObservation(rate);
+    estimator.update(rate, 0, 1);
+    lastForecast = estimator.getForecast(1u);
+}
+
+void HoltWintersArrivalRateForecaster::forecast(unsigned steps, Predictions& predictions) {
+    predictions.clear();
+
+    /*
+     * approximate the error of the forecast k steps ahead as that of k
+     * independent one step ahead errors
+     */
+    double stdDev = sqrt(squaredError);
+    for (unsigned k = 1; k <= steps; k++) {
+        predictions.push_back(Prediction { estimator.getForecast(k), stdDev * sqrt(k) });
+    }
+}
+
+
+ARArrivalRateForecaster::ARArrivalRateForecaster(cComponent* owner)
+    : ArrivalRateForecaster((int) owner->par("forecastHistory")) {
+    order = max(1, (int) owner->par("forecastAROrder"));
+}
+
+void ARArrivalRateForecaster::forecast(unsigned steps, Predictions& predictions) {
+    predictions.clear();
+    if (count == 0) {
+        predictions.assign(steps, Prediction { 0, 0 });
+        return;
+    }
+
+    double mean = 0;
+    for (size_t lag = 0; lag < count; lag++) {
+        mean += getLagged(lag);
+    }
+    mean /= count;
+
+    // autocovariances
+    unsigned p = min<size_t>(order, (count > 1) ? count - 1 : 0);
+    vector<double> autocov(p + 1, 0.0);
+    for (unsigned k = 0; k <= p; k++) {
+        for (size_t lag = 0; lag + k < count; lag++) {
+            autocov[k] += (getLagged(lag) - mean) * (getLagged(lag + k) - mean);
+        }
+        autocov[k] /= count;
+    }
+
+    // Levinson-Durbin
+    vector<double> phi(p + 1, 0.0);
+    double noiseVariance = autocov[0];
+    if (noiseVariance > 0) {
+        vector<double> previous(p + 1, 0.0);
+        for (unsigned k = 1; k <= p; k++) {
+            double reflection = autocov[k];
+            for (unsigned j = 1; j < k; j++) {
+                reflection -= previous[j] * autocov[k - j];
+            }
+            reflection /= noiseVariance;
+            phi[k] = reflection;
+            for (unsigned j = 1; j < k; j++) {
+                phi[j] = previous[j] - reflection * previous[k - j];
+            }
+            noiseVariance *= (1 - reflection * reflection);
+            previous = phi;
+        }
+    }
+
+    /*
+     * forecast recursively, and compute the error variance from the
+     * psi weights of the MA representation
+     */
+    vector<double> values; // deviations from the mean: past (most recent last), then forecasts
+    for (size_t lag = min<size_t>(p, count); lag > 0; lag--) {
+        values.push_back(getLagged(lag - 1) - mean);
+    }
+    vector<double> psi(1, 1.0);
+    double errorVariance = 0;
+    for (unsigned k = 1; k <= steps; k++) {
+        double value = 0;
+        for (unsigned j = 1; j <= p && j <= values.size(); j++) {
+            value += phi[j] * values[values.size() - j];
+        }
+        values.push_back(value);
+
+        errorVariance += psi[k - 1] * psi[k - 1];
+        double nextPsi = 0;
+        for (unsigned j = 1; j <= p && j <= k; j++) {
+            nextPsi += phi[j] * psi[k - j];
+        }
+        psi.push_back(nextPsi);
+
+        predictions.push_back(Prediction { mean + value, sqrt(max(0.0, noiseVariance * errorVariance)) });
+    }
+}
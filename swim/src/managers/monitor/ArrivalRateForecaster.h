@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#ifndef ARRIVALRATEFORECASTER_H_
+#define ARRIVALRATEFORECASTER_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include "ArrivalRateEstimator.h"
+
+/**
+ * Forecasts the arrival rate for a number of evaluation periods ahead,
+ * from the history of the rates measured at the end of each period
+ *
+ * The history is kept in a fixed-size ring buffer (forecastHistory
+ * periods), so memory does not grow with the length of the run.
+ */
+class ArrivalRateForecaster {
+public:
+    struct Prediction {
+        double rate; /**< requests/s */
+        double stdDev; /**< standard deviation of the forecast error */
+    };
+    typedef std::vector<Prediction> Predictions;
+
+    ArrivalRateForecaster(unsigned historySize);
+    virtual ~ArrivalRateForecaster();
+
+    /**
+     * Adds the rate measured in the last period
+     */
+    virtual void addObservation(double rate);
+
+    /**
+     * Forecasts the rate for the next periods
+     *
+     * @param steps number of periods ahead
+     * @param predictions filled with a prediction per period, the first
+     *   being for the next period
+     */
+    virtual void forecast(unsigned steps, Predictions& predictions) = 0;
+
+    /**
+     * Creates a forecaster, taking its parameters from the owner module
+     *
+     * @param name seasonalNaive, holtWinters or ar
+     * @return the forecaster, or nullptr if the name is not known
+     */
+    static ArrivalRateForecaster* create(const char* name, omnetpp::cComponent* owner);
+
+protected:
+    std::vector<double> history;
+    size_t head = 0; /**< index of the oldest observation */
+    size_t count = 0;
+
+    /**
+     * @param lag 0 for the most recent observation
+     */
+    inline double getLagged(size_t lag) const {
+        return history[(head + count - 1 - lag) % history.size()];
+    }
+};
+
+/**
+ * Repeats the last season (or the last observation if there is no
+ * complete season in the history)
+ */
+class SeasonalNaiveArrivalRateForecaster : public ArrivalRateForecaster {
+protected:
+    unsigned seasonLength;
+public:
+    SeasonalNaiveArrivalRateForecaster(omnetpp::cComponent* owner);
+    virtual void forecast(unsigned steps, Predictions& predictions);
+};
+
+/**
+ * Additive Holt-Winters, updated once per period
+ */
+class HoltWintersArrivalRateForecaster : public ArrivalRateForecaster {
+protected:
+    HoltWintersArrivalRateEstimator estimator;
+    double alpha;
+    double squaredError = 0; /**< smoothed one step ahead squared error */
+    double lastForecast = 0;
+public:
+    HoltWintersArrivalRateForecaster(omnetpp::cComponent* owner);
+    virtual void addObservation(double rate);
+    virtual void forecast(unsigned steps, Predictions& predictions);
+};
+
+/**
+ * Autoregressive model fitted to the history (Yule-Walker equations,
+ * solved with the Levinson-Durbin recursion) every period
+ */
+class ARArrivalRateForecaster : public ArrivalRateForecaster {
+protected:
+    unsigned order;
+public:
+    ARArrivalRateForecaster(omnetpp::cComponent* owner);
+    virtual void forecast(unsigned steps, Predictions& predictions);
+};
+
+#endif /* ARRIVALRATEFORECASTER_H_ */
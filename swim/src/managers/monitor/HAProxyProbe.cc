@@ -13,101 +13,174 @@
  * DM-0003883
  *******************************************************************************/
 #include "HAProxyProbe.h"
-#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <stdexcept>
 #include "managers/ModulePriorities.h"
-#include <managers/execution/ExecutionManagerModBase.h>
 
 using namespace std;
 using namespace omnetpp;
 
 Define_Module(HAProxyProbe);
 
-Observations HAProxyProbe::getUpdatedObservations() {
+namespace {
 
-    // update observations only if not stale
-    auto currentTime = boost::posix_time::microsec_clock::local_time();
-    if (!lastObservationsUpdate.is_not_a_date_time()
-            && (currentTime - lastObservationsUpdate).total_milliseconds()
-                    <= MEASUREMENT_OBSOLECENSE_MSEC) {
-        return observations;
+    /**
+     * Parses the number at pos in a comma separated line, without
+     * allocating, and moves pos to the next field
+     *
+     * @return false if there is no number at pos
+     */
+    bool parseField(const char*& pos, double& value) {
+        char* end;
+        value = strtod(pos, &end);
+        if (end == pos) {
+            return false;
+        }
+        pos = (*end == ',') ? end + 1 : end;
+        return true;
     }
+}
 
-    lastObservationsUpdate = currentTime;
-
-    tcpStream << "stats" << endl;
-    string response;
-    getline(tcpStream, response);
-    cout << "LogFileProbe stats response: " << response << endl;
-
-    stringstream responseStream(response);
-    string valueStr;
-    getline(responseStream, valueStr, ',');
-    // arrivalRate = stod(valueStr);
-    getline(responseStream, valueStr, ',');
-    ASSERT(valueStr == "2");
-    getline(responseStream, valueStr, ',');
-    observations.basicThroughput = stod(valueStr);
-    getline(responseStream, valueStr, ',');
-    observations.basicResponseTime = stod(valueStr) / 1000;
-    getline(responseStream, valueStr, ',');
-    observations.optThroughput = stod(valueStr);
-    if (!getline(responseStream, valueStr, ',')) {
-        error("response from LogFileProbe does not match expected format");
+HAProxyProbe::HAProxyProbe() : initEvent(nullptr), endWarmupEvent(nullptr), stopping(false),
+        pollingPeriodMsec(500), replyTimeoutMsec(2000), failedPolls(0), maxFailedPolls(10),
+        failedPollsReported(0), failedPollsSignal(0), lastRequestCounter(0), lastArrivalRate(0),
+        pModel(nullptr), pExecutionManager(nullptr) {
+}
+
+const HAProxyProbe::Snapshot& HAProxyProbe::readSnapshot() {
+    const Snapshot& snapshot = snapshots.read();
+    int failed = failedPolls;
+    if (failed >= maxFailedPolls) {
+        error("the last %d polls of LogFileProbe and HAProxy failed", failed);
+    }
+    if (failed != failedPollsReported) {
+        if (failed > 0) {
+            EV_WARN << "the last " << failed << " polls of LogFileProbe and HAProxy failed, using the observations taken at "
+                    << snapshot.time << endl;
+        }
+        emit(failedPollsSignal, (long) failed);
+        failedPollsReported = failed;
     }
-    observations.optResponseTime = stod(valueStr) / 1000;
+    return snapshot;
+}
 
+Observations HAProxyProbe::getUpdatedObservations() {
+    const Snapshot& snapshot = readSnapshot();
+
+    Observations observations;
+    observations.basicThroughput = snapshot.basicThroughput;
+    observations.basicResponseTime = snapshot.basicResponseTime;
+    observations.optThroughput = snapshot.optThroughput;
+    observations.optResponseTime = snapshot.optResponseTime;
     observations.avgResponseTime = (observations.basicResponseTime * observations.basicThroughput + observations.optResponseTime * observations.optThroughput)
             / (observations.basicThroughput + observations.optThroughput);
 
-    // get total utilization
+    // only take the utilization of the active servers
     observations.utilization = 0;
-    tcpStream << "util" << endl;
-    getline(tcpStream, response);
-    cout << "LogFileProbe util response: " << response << endl;
+    for (unsigned server = 1; server <= snapshot.utilization.size(); server++) {
+        if (pExecutionManager->isServerEnabled(server)) {
+            observations.utilization += snapshot.utilization[server - 1];
+        }
+    }
+    return observations;
+}
 
-    responseStream.clear();
-    responseStream.str(response);
+Environment HAProxyProbe::getUpdatedEnvironment() {
+    const Snapshot& snapshot = readSnapshot();
 
     /*
-     * only take the utilization of the active servers
-     * This assumes that if there are c active servers, the first c servers
-     * are the active ones
+     * the collector reads the request counter every polling period, but the
+     * rate is measured since the previous update, as it would be too noisy
+     * over a polling period. If there is no new reading, the rate is the same
      */
-    int activeServers = pModel->getActiveServers();
-    int server = 1;
-    utilization.clear();
-    while (server <= activeServers && getline(responseStream, valueStr, ',')) {
-        double serverUtilization = stod(valueStr) / 100.0;
-
-        // record in utilization table
-        stringstream serverId;
-        serverId << "server";
-        serverId << server;
-        utilization[serverId.str()] = serverUtilization;
-
-        // compute total utilization
-        observations.utilization += serverUtilization;
-        server++;
+    if (lastRequestCounterTime.is_not_a_date_time()) {
+        lastRequestCounter = snapshot.requestCounter;
+        lastRequestCounterTime = snapshot.time;
+    } else if (snapshot.time > lastRequestCounterTime) {
+        lastArrivalRate = (snapshot.requestCounter - lastRequestCounter)
+                / ((snapshot.time - lastRequestCounterTime).total_microseconds() / 1e6);
+        lastRequestCounter = snapshot.requestCounter;
+        lastRequestCounterTime = snapshot.time;
     }
-    return observations;
+    double arrivalRate = lastArrivalRate;
+    double measuredMeanInterArrival = (arrivalRate > 0) ? (1 / arrivalRate) : 0;
+
+    Environment environment;
+    environment.setArrivalMean(measuredMeanInterArrival);
+    environment.setArrivalVariance(pow(measuredMeanInterArrival, 2)); // assume exponential distribution
+    return environment;
 }
 
-Environment HAProxyProbe::getUpdatedEnvironment() {
+void HAProxyProbe::collect() {
+    unique_lock<mutex> lock(collectorMutex);
+    while (!stopping) {
+        lock.unlock();
+        if (poll(snapshots.getBack())) {
+            snapshots.publish();
+            failedPolls = 0;
+        } else {
+            failedPolls++;
+        }
+        lock.lock();
+        collectorWakeUp.wait_for(lock, chrono::milliseconds(pollingPeriodMsec), [this] { return stopping; });
+    }
+}
+
+bool HAProxyProbe::poll(Snapshot& snapshot) {
+    {
+        lock_guard<mutex> lock(tcpStreamMutex);
+        if (!tcpStream && !connectToLogFileProbe()) {
+            return false;
+        }
+
+        // the timeout covers both requests, so that a hung LogFileProbe does not hold the lock
+        tcpStream.expires_after(chrono::milliseconds(replyTimeoutMsec));
+        tcpStream << "stats" << endl;
+        getline(tcpStream, response);
+
+        // arrival rate, number of request classes (2), and throughput and response time (msec) of each
+        const char* pos = response.c_str();
+        double value;
+        if (!parseField(pos, value) || !parseField(pos, value) || value != 2
+                || !parseField(pos, snapshot.basicThroughput)
+                || !parseField(pos, snapshot.basicResponseTime)
+                || !parseField(pos, snapshot.optThroughput)
+                || !parseField(pos, snapshot.optResponseTime)) {
+            return false;
+        }
+        snapshot.basicResponseTime /= 1000;
+        snapshot.optResponseTime /= 1000;
 
-    // update environment only if not stale
-    auto currentTime = boost::posix_time::microsec_clock::local_time();
-    if (lastEnvironmentUpdate.is_not_a_date_time()
-            || (currentTime - lastEnvironmentUpdate).total_milliseconds()
-                    > MEASUREMENT_OBSOLECENSE_MSEC) {
-        lastEnvironmentUpdate = currentTime;
-        double arrivalRate = getAverageRequestRate();
-        double measuredMeanInterArrival = (arrivalRate > 0) ? (1 / arrivalRate) : 0;
-
-        environment.setArrivalMean(measuredMeanInterArrival);
-        environment.setArrivalVariance(pow(measuredMeanInterArrival, 2)); // assume exponential distribution
+        // utilization (%) of each server
+        tcpStream << "util" << endl;
+        getline(tcpStream, response);
+        snapshot.utilization.clear();
+        pos = response.c_str();
+        while (parseField(pos, value)) {
+            snapshot.utilization.push_back(value / 100.0);
+        }
     }
 
-    return environment;
+    try {
+        snapshot.time = boost::posix_time::microsec_clock::local_time();
+        snapshot.requestCounter = getRequestCounter();
+    } catch (const runtime_error& e) {
+        return false;
+    }
+    return true;
+}
+
+void HAProxyProbe::stopCollector() {
+    {
+        lock_guard<mutex> lock(collectorMutex);
+        stopping = true;
+    }
+    collectorWakeUp.notify_one();
+    if (collector.joinable()) {
+        collector.join();
+    }
 }
 
 void HAProxyProbe::handleMessage(cMessage* msg) {
@@ -122,12 +195,23 @@ void HAProxyProbe::handleMessage(cMessage* msg) {
         //sendReplayTraceSyncSignal();
     } else if (msg == endWarmupEvent) {
         // get time
-        tcpStream << "time" << endl;
         string response;
-        getline(tcpStream, response);
-        long epochTime = stol(response);
-        emit(registerSignal("hapHostBaseTime"), epochTime);
-        cout << "LogFileProbe time response: " << epochTime << endl;
+        {
+            lock_guard<mutex> lock(tcpStreamMutex);
+            if (tcpStream || connectToLogFileProbe()) {
+                tcpStream.expires_after(chrono::milliseconds(replyTimeoutMsec));
+                tcpStream << "time" << endl;
+                getline(tcpStream, response);
+            }
+        }
+        char* end;
+        long epochTime = strtol(response.c_str(), &end, 10);
+        if (end == response.c_str()) {
+            EV_WARN << "LogFileProbe did not reply the time: " << tcpStream.error().message() << endl;
+        } else {
+            emit(registerSignal("hapHostBaseTime"), epochTime);
+            cout << "LogFileProbe time response: " << epochTime << endl;
+        }
     }
 }
 
@@ -148,10 +232,15 @@ double HAProxyProbe::getOptThroughput() {
 }
 
 double HAProxyProbe::getUtilization(const std::string& serverName) {
-    getUpdatedObservations();
-    auto it = utilization.find(serverName);
-    if (it != utilization.end()) {
-        return it->second;
+    static const string prefix = "server";
+
+    // servers are named server<number>
+    const Snapshot& snapshot = snapshots.read();
+    if (serverName.compare(0, prefix.length(), prefix) == 0) {
+        int server = atoi(serverName.c_str() + prefix.length());
+        if (server >= 1 && server <= (int) snapshot.utilization.size() && pExecutionManager->isServerEnabled(server)) {
+            return snapshot.utilization[server - 1];
+        }
     }
 
     return -1.0; // error: server not found
@@ -166,7 +255,50 @@ double HAProxyProbe::getArrivalRate() {
     return rate;
 }
 
+double HAProxyProbe::getBasicResponseTimePercentile(double percentile) {
+    return -1.0; // not supported: the log file probe only reports averages
+}
+
+double HAProxyProbe::getOptResponseTimePercentile(double percentile) {
+    return -1.0;
+}
+
+double HAProxyProbe::getResponseTimePercentile(double percentile) {
+    return -1.0;
+}
+
+ServerObservations HAProxyProbe::getServerObservations(const std::string& serverName) {
+
+    // only utilization is available per server
+    ServerObservations server;
+    server.responseTime = -1.0;
+    server.throughput = -1.0;
+    server.queueLength = -1.0;
+    server.queueingDelay = -1.0;
+    server.utilization = getUtilization(serverName);
+    return server;
+}
+
+ServerObservations HAProxyProbe::getServerTypeObservations(int serverType) {
+    ServerObservations type;
+    type.responseTime = -1.0;
+    type.throughput = -1.0;
+    type.queueLength = -1.0;
+    type.queueingDelay = -1.0;
+    type.utilization = -1.0; // not supported
+    return type;
+}
+
+double HAProxyProbe::getQueueLength() {
+    return -1.0; // not supported
+}
+
+double HAProxyProbe::getQueueingDelay() {
+    return -1.0; // not supported
+}
+
 HAProxyProbe::~HAProxyProbe() {
+    stopCollector();
     cancelAndDelete(initEvent);
     cancelAndDelete(endWarmupEvent);
 }
@@ -193,26 +325,32 @@ void HAProxyProbe::initialize(int stage) {
         // send sync signal to start playing trace
         sendReplayTraceSyncSignal();
     } else if (stage == 1) {
-        serverRemovedSignal = registerSignal(ExecutionManagerModBase::SIG_SERVER_REMOVED);
-        getSimulation()->getSystemModule()->subscribe(serverRemovedSignal, this);
-
         pModel = check_and_cast<Model*>(
                 getParentModule()->getSubmodule("model"));
+        pExecutionManager = check_and_cast<ExecutionManagerHAProxy*>(
+                getParentModule()->getSubmodule("executionManager"));
 
         loadBalancer.setAddress(par("HAProxySocketPath").stringValue());
         lastRequestCounter = 0;
+        pollingPeriodMsec = (long) (par("pollingPeriod").doubleValue() * 1000);
+        replyTimeoutMsec = (long) (par("replyTimeout").doubleValue() * 1000);
+        maxFailedPolls = par("maxFailedPolls");
+        failedPollsSignal = registerSignal("failedPolls");
 
         // connect to the logfileprobe
         cout << "Connecting to LogFileProbe...";
-        tcpStream.connect("localhost", "5127");
-        if (!tcpStream) {
+        if (!connectToLogFileProbe()) {
           cout << "Error Unable to connect to LogFileProbe server: " << tcpStream.error().message() << endl;
           error("Error connecting to LogFileProbe");
         }
         cout << "done" << endl;
 
-        // set evaluation period for probing
-        tcpStream << "window " << (int) pModel->getEvaluationPeriod() << endl;
+        // the first poll is done here, so that there are observations from the start
+        if (!poll(snapshots.getBack())) {
+            error("response from LogFileProbe does not match expected format");
+        }
+        snapshots.publish();
+        collector = thread(&HAProxyProbe::collect, this);
 
         // schedule event to happen at time 0 after all the initialization to trigger trace replay
         initEvent = new cMessage("initEvent");
@@ -253,46 +391,34 @@ void HAProxyProbe::sampleRequestRate() {
 }
 #endif
 
-double HAProxyProbe::getAverageRequestRate() {
-    boost::posix_time::ptime counterResetTime = boost::posix_time::microsec_clock::local_time();
+double HAProxyProbe::getRequestCounter() {
     string reply = loadBalancer.executeCommand("show stat -1 1 -1\n");
 
     // skip the header line
-    size_t pos = reply.find_first_of('\n');
+    const char* pos = strchr(reply.c_str(), '\n');
 
     // 48. req_tot [.F..]: total number of HTTP requests received (columns start with idx 0)
     int column = 0;
-    while (pos != string::npos && column < 48) {
-        pos = reply.find_first_of(',', pos + 1);
+    while (pos != nullptr && column < 48) {
+        pos = strchr(pos + 1, ',');
         column++;
     }
-    ASSERT(pos != string::npos);
-    pos++;
-    string value = reply.substr(pos, reply.find_first_of(',', pos) - pos);
-    double requestCounter = atof(value.c_str());
-    double avgRequestRate = 0;
-    if (!lastCounterResetTime.is_not_a_date_time()) {
-        avgRequestRate =
-                (requestCounter - lastRequestCounter)
-                        / ((counterResetTime - lastCounterResetTime).total_milliseconds()
-                                / 1000.0);
+    if (pos == nullptr) {
+        throw runtime_error("HAProxyProbe::getRequestCounter unexpected reply from HAProxy");
     }
-    lastRequestCounter = requestCounter;
-    lastCounterResetTime = counterResetTime;
-
-    //cout << "measured interarrival rate " << rate << " pos " << pos << endl << reply << endl;
-    return avgRequestRate;
+    return strtod(pos + 1, nullptr);
 }
 
-void HAProxyProbe::connectToLogFileProbe() {
-
-}
-
-void HAProxyProbe::receiveSignal(cComponent *source, simsignal_t signalID, const char* value, cObject *details) {
-    if (signalID == serverRemovedSignal) {
-        auto it = utilization.find(value);
-        if (it != utilization.end()) {
-            utilization.erase(it);
-        }
+bool HAProxyProbe::connectToLogFileProbe() {
+    tcpStream.close();
+    tcpStream.clear();
+    tcpStream.expires_after(chrono::milliseconds(replyTimeoutMsec));
+    tcpStream.connect("localhost", "5127");
+    if (!tcpStream) {
+        return false;
     }
+
+    // set evaluation period for probing
+    tcpStream << "window " << (int) pModel->getEvaluationPeriod() << endl;
+    return true;
 }
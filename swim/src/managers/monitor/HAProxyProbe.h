@@ -18,37 +18,96 @@
 #include <boost/asio.hpp>
 #include "IProbe.h"
 #include "util/HAProxySocketCommand.h"
+#include "util/SnapshotBuffer.h"
 #include "boost/date_time/posix_time/posix_time.hpp"
-#include <map>
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include "model/Model.h"
+#include "managers/execution/ExecutionManagerHAProxy.h"
 
 
 /**
  * This class collects statistics from the system running with HAProxy
+ *
+ * LogFileProbe and HAProxy are polled by a collector thread at a fixed
+ * rate, so that a slow reply does not stall the simulation. The getters
+ * only read the latest snapshot it published, and the simulation stops
+ * if too many polls in a row fail
  */
-class HAProxyProbe : public IProbe, omnetpp::cListener
+class HAProxyProbe : public IProbe
 {
+    /**
+     * Measurements of the system taken in one poll
+     */
+    struct Snapshot {
+        double basicThroughput = 0;
+        double basicResponseTime = 0; // in seconds
+        double optThroughput = 0;
+        double optResponseTime = 0; // in seconds
+        std::vector<double> utilization; // in [0, 1], indexed by server number - 1
+        double requestCounter = 0; // total requests received by HAProxy
+        boost::posix_time::ptime time; // when the snapshot was taken, just before reading requestCounter
+    };
+
     HAProxySocketCommand loadBalancer;
-    double getAverageRequestRate();
 
     boost::asio::ip::tcp::iostream tcpStream;
+    std::mutex tcpStreamMutex; /**< tcpStream is used by the collector and the simulation */
     omnetpp::cMessage *initEvent; /**< event to trigger trace replay */
     omnetpp::cMessage *endWarmupEvent; /**< event to get time from HAP host */
 
-  protected:
-    long long lastRequestCounter;
-    boost::posix_time::ptime lastCounterResetTime;
-
-    boost::posix_time::ptime lastEnvironmentUpdate;
-    boost::posix_time::ptime lastObservationsUpdate;
-    Environment environment;
-    Observations observations;
-    std::map<std::string, double> utilization;
+    SnapshotBuffer<Snapshot> snapshots;
+    std::thread collector;
+    std::mutex collectorMutex;
+    std::condition_variable collectorWakeUp;
+    bool stopping; /**< guarded by collectorMutex */
+    long pollingPeriodMsec;
+    long replyTimeoutMsec; /**< how long to wait for a reply from LogFileProbe */
+    std::atomic<int> failedPolls; /**< polls that failed since the last snapshot was published */
+
+    // only used by the collector thread
+    std::string response; /**< reused for every reply from LogFileProbe */
+
+    // only used by the simulation
+    int maxFailedPolls;
+    int failedPollsReported; /**< failed polls the last warning was about */
+    omnetpp::simsignal_t failedPollsSignal;
+
+    // only used by the simulation, to get the arrival rate since the previous environment update
+    double lastRequestCounter;
+    boost::posix_time::ptime lastRequestCounterTime;
+    double lastArrivalRate;
+
+    /**
+     * Body of the collector thread
+     */
+    void collect();
+
+    /**
+     * Polls LogFileProbe and HAProxy. If the connection to LogFileProbe
+     * failed (e.g., a reply timed out), it reconnects first
+     *
+     * @return false if a reply did not arrive or did not have the expected format
+     */
+    bool poll(Snapshot& snapshot);
+
+    /**
+     * @return the latest snapshot published. It warns about the polls that
+     *   failed since it was taken, and stops the simulation if there are
+     *   maxFailedPolls of them
+     */
+    const Snapshot& readSnapshot();
+
+    double getRequestCounter();
+    void stopCollector();
 
+  protected:
     Model* pModel;
-
-    omnetpp::simsignal_t serverRemovedSignal;
+    ExecutionManagerHAProxy* pExecutionManager; /**< knows which servers are active */
 
     virtual void initialize(int stage);
     virtual void handleMessage(omnetpp::cMessage *msg);
@@ -59,18 +118,28 @@ class HAProxyProbe : public IProbe, omnetpp::cListener
     double getOptThroughput();
     double getUtilization(const std::string& serverName);
     double getArrivalRate();
+    double getBasicResponseTimePercentile(double percentile);
+    double getOptResponseTimePercentile(double percentile);
+    double getResponseTimePercentile(double percentile);
+    ServerObservations getServerObservations(const std::string& serverName);
+    ServerObservations getServerTypeObservations(int serverType);
+    double getQueueLength();
+    double getQueueingDelay();
 
     Observations getUpdatedObservations();
     Environment getUpdatedEnvironment();
 
-    void connectToLogFileProbe();
+    /**
+     * (Re)connects tcpStream to LogFileProbe. Must be called with
+     * tcpStreamMutex locked, except during initialization
+     *
+     * @return false if it could not connect
+     */
+    bool connectToLogFileProbe();
     void sendReplayTraceSyncSignal();
 
   public:
-    const unsigned MEASUREMENT_OBSOLECENSE_MSEC = 500;
-
-    void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, const char* value, cObject *details) override;
-
+    HAProxyProbe();
     virtual ~HAProxyProbe();
 };
 
@@ -32,6 +32,48 @@ public:
     virtual double getUtilization(const std::string& serverName) = 0;
     virtual double getArrivalRate() = 0;
 
+    /**
+     * Response time percentiles in the current window, per request class
+     * and for all requests
+     *
+     * @param percentile in (0, 100]
+     * @return the percentile, or -1 if not supported by the probe or if
+     *   no request completed in the window
+     */
+    virtual double getBasicResponseTimePercentile(double percentile) = 0;
+    virtual double getOptResponseTimePercentile(double percentile) = 0;
+    virtual double getResponseTimePercentile(double percentile) = 0;
+
+    /**
+     * Observations of one server
+     *
+     * @return the observations, with utilization < 0 if the server does
+     *   not exist
+     */
+    virtual ServerObservations getServerObservations(const std::string& serverName) = 0;
+
+    /**
+     * Observations of all the servers of a type
+     *
+     * @param serverType a MTServerType::ServerType
+     * @return the observations, with utilization < 0 if not supported
+     */
+    virtual ServerObservations getServerTypeObservations(int serverType) = 0;
+
+    /**
+     * Time-weighted mean of the total queue length in the current window
+     *
+     * @return the queue length, or -1 if not supported by the probe
+     */
+    virtual double getQueueLength() = 0;
+
+    /**
+     * Mean queueing delay of the requests in the current window
+     *
+     * @return the delay, or -1 if not supported by the probe
+     */
+    virtual double getQueueingDelay() = 0;
+
     /**
      * Computes the statistics of observations
      *
@@ -15,6 +15,7 @@
 #include "SimProbe.h"
 #include <model/Model.h>
 #include <managers/execution/ExecutionManagerModBase.h>
+#include "PassiveQueue.h"
 
 using namespace omnetpp;
 
@@ -35,12 +36,51 @@ void SimProbe::initialize(int stage)
         serverRemovedSignal = registerSignal(ExecutionManagerModBase::SIG_SERVER_REMOVED);
         getSimulation()->getSystemModule()->subscribe(serverRemovedSignal, this);
 
+        serverActivatedSignal = registerSignal(ExecutionManagerModBase::SIG_SERVER_ACTIVATED);
+        getSimulation()->getSystemModule()->subscribe(serverActivatedSignal, this);
+
+        serverResponseTimeSignal = registerSignal("responseTime");
+        getSimulation()->getSystemModule()->subscribe(serverResponseTimeSignal, this);
+
+        queueLengthSignal = registerSignal("queueLength");
+        getSimulation()->getSystemModule()->subscribe(queueLengthSignal, this);
+
+        queueingTimeSignal = registerSignal("queueingTime");
+        getSimulation()->getSystemModule()->subscribe(queueingTimeSignal, this);
+
+        basicSinkId = getParentModule()->getSubmodule("sinkLow")->getId();
+        cModule* sharedQueue = getParentModule()->getSubmodule("sharedQueue");
+        sharedQueueId = sharedQueue ? sharedQueue->getId() : -1;
+        pExecMgr = check_and_cast<ExecutionManagerModBase*>(
+                        getParentModule()->getSubmodule("executionManager"));
+
         Model* pModel = check_and_cast<Model*>(
                         getParentModule()->getSubmodule("model"));
         window = pModel->getEvaluationPeriod();
+        statsBuckets = par("statsBuckets");
         arrival.setWindow(window);
+        arrival.setBuckets(statsBuckets);
         basicResponseTime.setWindow(window);
+        basicResponseTime.setBuckets(statsBuckets);
         optResponseTime.setWindow(window);
+        optResponseTime.setBuckets(statsBuckets);
+        queueingDelay.setWindow(window);
+        queueingDelay.setBuckets(statsBuckets);
+        sharedQueueLength.setWindow(window);
+        typeResponseTime.resize(pModel->getNumberOfServerTypes() + 1);
+        typeQueueingDelay.resize(typeResponseTime.size());
+        for (auto& stats : typeResponseTime) {
+            stats.setWindow(window);
+            stats.setBuckets(statsBuckets);
+        }
+        for (auto& stats : typeQueueingDelay) {
+            stats.setWindow(window);
+            stats.setBuckets(statsBuckets);
+        }
+
+        unsigned percentileSubWindows = par("percentileSubWindows");
+        basicResponseTimeHistogram.setWindow(window, percentileSubWindows);
+        optResponseTimeHistogram.setWindow(window, percentileSubWindows);
     }
 }
 
@@ -61,9 +101,10 @@ double SimProbe::getOptThroughput() {
 }
 
 double SimProbe::getUtilization(const std::string& serverName) {
-    auto it = utilization.find(serverName);
-    if (it != utilization.end()) {
-        return it->second.getPercentageAboveZero();
+    for (unsigned slot = 0; slot < serverNames.size(); slot++) {
+        if (serverNames[slot] == serverName) {
+            return utilization[slot].getAverage();
+        }
     }
 
     return -1.0; // error: server not found
@@ -73,6 +114,82 @@ double SimProbe::getArrivalRate() {
     return arrival.getRate();
 }
 
+double SimProbe::getBasicResponseTimePercentile(double percentile) {
+    return basicResponseTimeHistogram.getPercentile(percentile);
+}
+
+double SimProbe::getOptResponseTimePercentile(double percentile) {
+    return optResponseTimeHistogram.getPercentile(percentile);
+}
+
+double SimProbe::getResponseTimePercentile(double percentile) {
+    return TimeWindowHistogram::getPercentile(percentile,
+            { &basicResponseTimeHistogram, &optResponseTimeHistogram });
+}
+
+ServerObservations SimProbe::getSlotObservations(int slot) {
+    ServerObservations server;
+    server.servers = 1;
+    server.responseTime = serverResponseTime[slot].getAverage();
+    server.throughput = serverResponseTime[slot].getRate();
+    server.utilization = utilization[slot].getAverage();
+    server.queueLength = serverQueueLength[slot].getAverage();
+    server.queueingDelay = serverQueueingDelay[slot].getAverage();
+    return server;
+}
+
+double SimProbe::getQueueLength() {
+    double queueLength = 0;
+    for (unsigned slot = 0; slot < serverNames.size(); slot++) {
+        if (!serverNames[slot].empty()) {
+            queueLength += serverQueueLength[slot].getAverage();
+        }
+    }
+    if (sharedQueueId >= 0) {
+        queueLength += sharedQueueLength.getAverage();
+    }
+    return queueLength;
+}
+
+double SimProbe::getQueueingDelay() {
+    return queueingDelay.getAverage();
+}
+
+ServerObservations SimProbe::getServerObservations(const std::string& serverName) {
+    for (unsigned slot = 0; slot < serverNames.size(); slot++) {
+        if (serverNames[slot] == serverName) {
+            return getSlotObservations(slot);
+        }
+    }
+
+    ServerObservations notFound;
+    notFound.utilization = -1.0;
+    return notFound;
+}
+
+ServerObservations SimProbe::getServerTypeObservations(int serverType) {
+    ServerObservations type;
+    if (serverType <= MTServerType::NONE || serverType >= (int) typeResponseTime.size()) {
+        type.utilization = -1.0;
+        return type;
+    }
+
+    type.responseTime = typeResponseTime[serverType].getAverage();
+    type.throughput = typeResponseTime[serverType].getRate();
+    type.queueingDelay = typeQueueingDelay[serverType].getAverage();
+    for (unsigned slot = 0; slot < serverNames.size(); slot++) {
+        if (!serverNames[slot].empty() && serverTypes[slot] == serverType) {
+            type.servers++;
+            type.utilization += utilization[slot].getAverage();
+            type.queueLength += serverQueueLength[slot].getAverage();
+        }
+    }
+    if (type.servers > 0) {
+        type.utilization /= type.servers;
+    }
+    return type;
+}
+
 void SimProbe::handleMessage(cMessage *msg)
 {
     // TODO - Generated method body
@@ -81,12 +198,31 @@ void SimProbe::handleMessage(cMessage *msg)
 void SimProbe::receiveSignal(cComponent *source, simsignal_t signalID,
         const SimTime& t, cObject *details) {
     if (signalID == lifeTimeSignal) {
-        bool basicService = (strcmp(source->getName(), "sinkLow") == 0);
+        bool basicService = (source->getId() == basicSinkId);
         if (basicService) {
             basicResponseTime.record(t.dbl());
+            basicResponseTimeHistogram.record(t.dbl());
         } else {
             optResponseTime.record(t.dbl());
+            optResponseTimeHistogram.record(t.dbl());
        }
+    } else if (signalID == serverResponseTimeSignal) {
+        int slot = getServerSlot(source->getId());
+        if (slot >= 0) {
+            serverResponseTime[slot].record(t.dbl());
+            typeResponseTime[serverTypes[slot]].record(t.dbl());
+        }
+    } else if (signalID == queueingTimeSignal) {
+        int slot = getServerSlot(source->getId());
+        if (slot >= 0) {
+            queueingDelay.record(t.dbl());
+            serverQueueingDelay[slot].record(t.dbl());
+            typeQueueingDelay[serverTypes[slot]].record(t.dbl());
+        } else if (source->getId() == sharedQueueId) {
+
+            // the server the request goes to is not known, so it only counts for the total
+            queueingDelay.record(t.dbl());
+        }
     }
 }
 
@@ -94,23 +230,30 @@ void SimProbe::receiveSignal(cComponent *source, simsignal_t signalID,
 void SimProbe::receiveSignal(cComponent *source, simsignal_t signalID,
         bool value, cObject *details) {
     if (signalID == serverBusySignal) {
-        std::string serverName = source->getParentModule()->getName(); // because it is nested
-        auto it = utilization.find(serverName);
-        if (it != utilization.end()) {
-            it->second.record((value) ? 1.0 : 0.0); // busy vs idle
+        int slot = getServerSlot(source->getId());
+        if (slot >= 0) {
+            utilization[slot].setLevel((value) ? 1.0 : 0.0); // busy vs idle
         } else {
 
             /*
              * a new server emits a busy=false signal when it is initialized.
              * It should not be recorded for a new server because it then
-             * throws off the sliding window avg utilization computation
+             * throws off the sliding window avg utilization computation.
+             * Servers activated before this probe subscribed are added
+             * the first time they are busy
              */
             if (value) {
-                auto& util = utilization[serverName];
-                util.setWindow(window);
-                util.record(1.0); // busy
+                slot = addServer(check_and_cast<cModule*>(source));
+                utilization[slot].busy();
             }
         }
+    } else if (signalID == serverActivatedSignal) {
+
+        // details is the server module added to the system
+        cModule* server = check_and_cast<cModule*>(details)->getSubmodule("server");
+        if (getServerSlot(server->getId()) < 0) {
+            addServer(server);
+        }
     }
 }
 
@@ -125,8 +268,10 @@ Observations SimProbe::getUpdatedObservations() {
     Observations obs;
     obs.utilization = 0;
 
-    for (auto& entry : utilization) {
-        obs.utilization += entry.second.getPercentageAboveZero();
+    for (unsigned slot = 0; slot < utilization.size(); slot++) {
+        if (!serverNames[slot].empty()) {
+            obs.utilization += utilization[slot].getAverage();
+        }
     }
 
     obs.basicResponseTime = getBasicResponseTime();
@@ -136,6 +281,27 @@ Observations SimProbe::getUpdatedObservations() {
     obs.avgResponseTime = (obs.basicResponseTime * obs.basicThroughput + obs.optResponseTime * obs.optThroughput)
             / (obs.basicThroughput + obs.optThroughput);
 
+    obs.responseTimeP50 = getResponseTimePercentile(50);
+    obs.responseTimeP95 = getResponseTimePercentile(95);
+    obs.responseTimeP99 = getResponseTimePercentile(99);
+    obs.basicResponseTimeP95 = getBasicResponseTimePercentile(95);
+    obs.basicResponseTimeP99 = getBasicResponseTimePercentile(99);
+    obs.optResponseTimeP95 = getOptResponseTimePercentile(95);
+    obs.optResponseTimeP99 = getOptResponseTimePercentile(99);
+
+    obs.queueLength = getQueueLength();
+    obs.queueingDelay = getQueueingDelay();
+
+    obs.serverTypes.resize(typeResponseTime.size());
+    for (int type = MTServerType::NONE + 1; type < (int) typeResponseTime.size(); type++) {
+        obs.serverTypes[type] = getServerTypeObservations(type);
+    }
+    for (unsigned slot = 0; slot < serverNames.size(); slot++) {
+        if (!serverNames[slot].empty()) {
+            obs.servers[serverNames[slot]] = getSlotObservations(slot);
+        }
+    }
+
     return obs;
 }
 
@@ -145,16 +311,77 @@ Environment SimProbe::getUpdatedEnvironment() {
 
     Environment environment;
     environment.setArrivalMean(measuredMeanInterArrival);
-    environment.setArrivalVariance(pow(measuredMeanInterArrival, 2)); // assume exponential distribution
+    if (arrival.getCount() > 1) {
+        environment.setArrivalVariance(arrival.getVariance());
+    } else {
+        environment.setArrivalVariance(pow(measuredMeanInterArrival, 2)); // assume exponential distribution
+    }
+    environment.setArrivalRateForecast(arrivalRate);
     return environment;
 }
 
 
-void SimProbe::receiveSignal(cComponent *source, simsignal_t signalID, const char* value, cObject *details) {
-    if (signalID == serverRemovedSignal) {
-        auto it = utilization.find(value);
-        if (it != utilization.end()) {
-            utilization.erase(it);
+void SimProbe::receiveSignal(cComponent *source, simsignal_t signalID, long value, cObject *details) {
+    if (signalID == queueLengthSignal) {
+        int slot = getServerSlot(source->getId());
+        if (slot >= 0) {
+            serverQueueLength[slot].setLevel(value);
+        } else if (source->getId() == sharedQueueId) {
+            sharedQueueLength.setLevel(value);
+        }
+    } else if (signalID == serverRemovedSignal && details) {
+
+        // details is the server module being removed
+        removeServer(check_and_cast<cModule*>(details)->getSubmodule("server"));
+    }
+}
+
+int SimProbe::addServer(cModule* server) {
+    int slot;
+    if (freeSlots.empty()) {
+        slot = serverNames.size();
+        serverNames.emplace_back();
+        utilization.emplace_back();
+        serverResponseTime.emplace_back();
+        serverTypes.emplace_back();
+        serverQueueLength.emplace_back();
+        serverQueueingDelay.emplace_back();
+    } else {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    cModule* appServer = server->getParentModule(); // because it is nested
+    serverNames[slot] = appServer->getName();
+    serverTypes[slot] = pExecMgr->getServerType(appServer);
+    utilization[slot].setWindow(window);
+    serverResponseTime[slot].setWindow(window);
+    serverResponseTime[slot].setBuckets(statsBuckets); // also resets it
+    serverQueueingDelay[slot].setWindow(window);
+    serverQueueingDelay[slot].setBuckets(statsBuckets);
+
+    serverQueueLength[slot].setWindow(window);
+    setSlot(server->getId(), slot);
+
+    // servers that pull from a shared queue do not have one
+    cModule* queueModule = appServer->getSubmodule("queue");
+    if (queueModule) {
+        auto queue = check_and_cast<queueing::PassiveQueue*>(queueModule);
+        serverQueueLength[slot].setLevel(queue->length());
+        setSlot(queue->getId(), slot);
+    }
+
+    return slot;
+}
+
+void SimProbe::removeServer(cModule* server) {
+    int slot = getServerSlot(server->getId());
+    if (slot >= 0) {
+        serverSlots[server->getId()] = -1;
+        cModule* queue = server->getParentModule()->getSubmodule("queue");
+        if (queue) {
+            serverSlots[queue->getId()] = -1;
         }
+        serverNames[slot].clear();
+        freeSlots.push_back(slot);
     }
 }
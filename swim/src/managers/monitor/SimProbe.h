@@ -16,7 +16,14 @@
 #define __PLASASIM_SIMPROBE_H_
 
 #include "IProbe.h"
+#include <vector>
+#include <string>
 #include <util/TimeWindowStats.h>
+#include <util/TimeWindowHistogram.h>
+#include <util/TimeWindowLevel.h>
+#include <modules/MTServerType.h>
+
+class ExecutionManagerModBase;
 
 /**
  * This class collects statistics from the simulated system
@@ -26,8 +33,8 @@ class SimProbe : public IProbe, omnetpp::cListener
 public:
     void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, const omnetpp::SimTime& t, cObject *details) override;
     void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, bool value, cObject *details) override;
+    void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, long value, cObject *details) override;
     void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, double value, cObject *details) override;
-    void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, const char* value, cObject *details) override;
 
     double getBasicResponseTime();
     double getOptResponseTime();
@@ -35,6 +42,13 @@ public:
     double getOptThroughput();
     double getUtilization(const std::string& serverName);
     double getArrivalRate();
+    double getBasicResponseTimePercentile(double percentile);
+    double getOptResponseTimePercentile(double percentile);
+    double getResponseTimePercentile(double percentile);
+    ServerObservations getServerObservations(const std::string& serverName);
+    ServerObservations getServerTypeObservations(int serverType);
+    double getQueueLength();
+    double getQueueingDelay();
 
     Observations getUpdatedObservations();
     Environment getUpdatedEnvironment();
@@ -45,13 +59,67 @@ protected:
     omnetpp::simsignal_t interArrivalSignal;
     omnetpp::simsignal_t serverBusySignal;
     omnetpp::simsignal_t serverRemovedSignal;
+    omnetpp::simsignal_t serverActivatedSignal;
+    omnetpp::simsignal_t serverResponseTimeSignal;
+    omnetpp::simsignal_t queueLengthSignal;
+    omnetpp::simsignal_t queueingTimeSignal;
+
+    int basicSinkId; /**< module id of the sink of requests with basic service */
+    int sharedQueueId; /**< module id of the queue shared by all servers, -1 if each has its own */
+    TimeWindowLevel sharedQueueLength; /**< length of the shared queue, if any */
+    ExecutionManagerModBase* pExecMgr;
 
     unsigned window; /**< time window in seconds for statistics */
+    unsigned statsBuckets; /**< buckets per window, 0 for exact windows */
     TimeWindowStats arrival;
     TimeWindowStats basicResponseTime;
     TimeWindowStats optResponseTime;
+    TimeWindowHistogram basicResponseTimeHistogram;
+    TimeWindowHistogram optResponseTimeHistogram;
+    TimeWindowStats queueingDelay; /**< queueing delay of all the requests */
+
+    /*
+     * Per server statistics are kept in vectors indexed by a dense slot
+     * that is assigned to the server when it is activated (or seen busy
+     * for the first time), so that signals can be handled without name
+     * lookups. Slots of removed servers are reused.
+     */
+    std::vector<int> serverSlots; /**< slot indexed by module id of the server (and of its queue), -1 if none */
+    std::vector<std::string> serverNames; /**< name indexed by slot, empty if the slot is free */
+    std::vector<TimeWindowLevel> utilization; /**< indexed by slot */
+    std::vector<TimeWindowStats> serverResponseTime; /**< indexed by slot */
+    std::vector<MTServerType::ServerType> serverTypes; /**< indexed by slot */
+    std::vector<TimeWindowLevel> serverQueueLength; /**< time-weighted, indexed by slot */
+    std::vector<TimeWindowStats> serverQueueingDelay; /**< indexed by slot */
+    std::vector<int> freeSlots;
+
+    /** response time of the jobs served by each server type, indexed by type id */
+    std::vector<TimeWindowStats> typeResponseTime;
+
+    /** queueing delay of the jobs queued in each server type, indexed by type id */
+    std::vector<TimeWindowStats> typeQueueingDelay;
+
+    inline void setSlot(int moduleId, int slot) {
+        if (moduleId >= (int) serverSlots.size()) {
+            serverSlots.resize(moduleId + 1, -1);
+        }
+        serverSlots[moduleId] = slot;
+    }
+
+    inline int getServerSlot(int moduleId) const {
+        return (moduleId < (int) serverSlots.size()) ? serverSlots[moduleId] : -1;
+    }
+
+    /**
+     * Assigns a slot to a server, and starts measuring its utilization
+     *
+     * @param server the server module (the one emitting busy signals)
+     * @return the slot
+     */
+    int addServer(omnetpp::cModule* server);
+    void removeServer(omnetpp::cModule* server);
 
-    std::map<std::string, TimeWindowStats> utilization;
+    ServerObservations getSlotObservations(int slot);
 
     virtual int numInitStages() const {return 2;}
     virtual void initialize(int stage);
@@ -15,6 +15,8 @@
 #include "SimpleMonitor.h"
 
 #include <cmath>
+#include <cstring>
+#include <algorithm>
 #include "managers/adaptation/UtilityScorer.h"
 #include "managers/ModulePriorities.h"
 #include "managers/execution/ExecutionManagerModBase.h"
@@ -28,6 +30,8 @@ SimpleMonitor::SimpleMonitor()
 {
     periodEvent = 0;
     periodPostEvent = 0;
+    pArrivalRateEstimator = nullptr;
+    pArrivalRateForecaster = nullptr;
 }
 
 void SimpleMonitor::initialize(int stage) {
@@ -38,6 +42,8 @@ void SimpleMonitor::initialize(int stage) {
         measuredInterarrivalStdDev = registerSignal("measuredInterarrivalStdDev");
         utilitySignal = registerSignal("utility");
         brownoutFactorSignal = registerSignal("brownoutFactor");
+        estimatedArrivalRateSignal = registerSignal("estimatedArrivalRate");
+        arrivalRateForecastSignal = registerSignal("arrivalRateForecast");
 
         serverRemovedSignal = registerSignal(ExecutionManagerModBase::SIG_SERVER_REMOVED);
         serverAddedSignal = registerSignal(ExecutionManagerModBase::SIG_SERVER_ADDED);
@@ -56,6 +62,30 @@ void SimpleMonitor::initialize(int stage) {
                 getParentModule()->getSubmodule("model"));
         pProbe = check_and_cast<IProbe*> (gate("probe")->getPreviousGate()->getOwnerModule());
 
+        const char* estimatorName = par("arrivalRateEstimator");
+        if (strcmp(estimatorName, "none") != 0) {
+            pArrivalRateEstimator = ArrivalRateEstimator::create(estimatorName, this);
+            if (!pArrivalRateEstimator) {
+                error("invalid arrival rate estimator");
+            }
+        }
+        lastEstimatorUpdate = simTime();
+        forecastHorizon = par("forecastHorizon");
+        if (forecastHorizon < 0) {
+            forecastHorizon = pModel->getEvaluationPeriod();
+        }
+
+        const char* forecasterName = par("arrivalRateForecaster");
+        if (strcmp(forecasterName, "none") != 0) {
+            pArrivalRateForecaster = ArrivalRateForecaster::create(forecasterName, this);
+            if (!pArrivalRateForecaster) {
+                error("invalid arrival rate forecaster");
+            }
+        }
+
+        // < 0 to forecast as far as the model horizon, which covers the boot delay
+        forecastSteps = par("forecastSteps");
+
         // Create the event objects we'll use for timing -- just any ordinary message.
         periodEvent = new cMessage("periodEvent");
         periodEvent->setSchedulingPriority(MONITOR_PRE_PRIO);
@@ -109,6 +139,9 @@ void SimpleMonitor::handleMessage(cMessage *msg) {
 void SimpleMonitor::periodicHandler() {
     Observations observations = pProbe->getUpdatedObservations();
     pModel->setObservations(observations);
+    if (pArrivalRateForecaster) {
+        forecastEnvironment();
+    }
 
     const Environment& env = pModel->getEnvironment();
     emit(measuredInterarrivalAvg, env.getArrivalMean());
@@ -122,9 +155,72 @@ void SimpleMonitor::periodicHandler() {
 
 void SimpleMonitor::oversamplingHandler() {
     Environment environment = pProbe->getUpdatedEnvironment();
+    if (pArrivalRateEstimator) {
+        estimateArrivalRate(environment);
+    }
     pModel->setEnvironment(environment);
 }
 
+void SimpleMonitor::estimateArrivalRate(Environment& environment) {
+    double interval = (simTime() - lastEstimatorUpdate).dbl();
+    lastEstimatorUpdate = simTime();
+
+    double measuredMean = environment.getArrivalMean();
+    double measuredRate = (measuredMean > 0) ? 1 / measuredMean : 0;
+
+    /*
+     * variance of the rate measured over the probe window, from the
+     * variance of the inter-arrival times and the number of arrivals in
+     * the window (window * rate), using the delta method for 1/mean
+     */
+    double variance = 0;
+    if (measuredMean > 0) {
+        variance = environment.getArrivalVariance() / (pModel->getEvaluationPeriod() * pow(measuredMean, 3));
+    }
+
+    pArrivalRateEstimator->update(measuredRate, variance, interval);
+
+    double rate = max(0.0, pArrivalRateEstimator->getRate());
+    double forecast = max(0.0, pArrivalRateEstimator->getForecast(forecastHorizon));
+    emit(estimatedArrivalRateSignal, rate);
+    emit(arrivalRateForecastSignal, forecast);
+
+    if (rate > 0) {
+
+        // keep the measured coefficient of variation of the inter-arrival times
+        double mean = 1 / rate;
+        if (measuredMean > 0) {
+            environment.setArrivalVariance(environment.getArrivalVariance() * pow(mean / measuredMean, 2));
+        }
+        environment.setArrivalMean(mean);
+    }
+    environment.setArrivalRateForecast(forecast);
+}
+
+void SimpleMonitor::forecastEnvironment() {
+    pArrivalRateForecaster->addObservation(pProbe->getArrivalRate());
+    pArrivalRateForecaster->forecast((forecastSteps < 0) ? pModel->getHorizon() : forecastSteps, predictions);
+
+    // keep the coefficient of variation of the inter-arrival times
+    const Environment& current = pModel->getEnvironment();
+    double scv = 1; // assume exponential if there are no arrivals
+    if (current.getArrivalMean() > 0) {
+        scv = current.getArrivalVariance() / pow(current.getArrivalMean(), 2);
+    }
+
+    EnvironmentVector forecast;
+    forecast.reserve(predictions.size());
+    for (const auto& prediction : predictions) {
+        double rate = max(0.0, prediction.rate);
+        double mean = (rate > 0) ? 1 / rate : 0;
+        Environment environment(mean, scv * mean * mean);
+        environment.setArrivalRateForecast(rate);
+        environment.setArrivalRateStdDev(prediction.stdDev);
+        forecast.push_back(environment);
+    }
+    pModel->setEnvironmentForecast(forecast);
+}
+
 void SimpleMonitor::postPeriodHandler() {
     emit(numberOfServersSignal, pModel->getServers());
     emit(activeServersSignal,
@@ -163,5 +259,7 @@ SimpleMonitor::~SimpleMonitor() {
     cancelAndDelete(periodEvent);
     cancelAndDelete(periodPostEvent);
     cancelAndDelete(oversamplingEvent);
+    delete pArrivalRateEstimator;
+    delete pArrivalRateForecaster;
 }
 
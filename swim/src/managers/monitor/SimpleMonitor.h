@@ -20,6 +20,8 @@
 #include <memory>
 #include "model/Model.h"
 #include "IProbe.h"
+#include "ArrivalRateEstimator.h"
+#include "ArrivalRateForecaster.h"
 
 #define DLL_PUBLIC __attribute__ ((visibility("default")))
 
@@ -46,12 +48,34 @@ class DLL_PUBLIC SimpleMonitor : public omnetpp::cSimpleModule, omnetpp::cListen
     omnetpp::simsignal_t measuredInterarrivalStdDev;
     omnetpp::simsignal_t utilitySignal;
     omnetpp::simsignal_t brownoutFactorSignal;
+    omnetpp::simsignal_t estimatedArrivalRateSignal;
+    omnetpp::simsignal_t arrivalRateForecastSignal;
 
     Model* pModel;
     IProbe* pProbe;
 
     unsigned oversamplingFactor;
 
+    ArrivalRateEstimator* pArrivalRateEstimator; /**< null if not estimating */
+    omnetpp::simtime_t lastEstimatorUpdate;
+    double forecastHorizon; /**< in seconds */
+
+    /**
+     * Replaces the measured arrival rate in the environment with the
+     * estimate, and adds the forecast
+     */
+    virtual void estimateArrivalRate(Environment& environment);
+
+    ArrivalRateForecaster* pArrivalRateForecaster; /**< null if not forecasting */
+    ArrivalRateForecaster::Predictions predictions;
+    int forecastSteps;
+
+    /**
+     * Adds the rate measured in the last period to the forecaster, and
+     * updates the environment forecast in the model
+     */
+    virtual void forecastEnvironment();
+
     virtual int numInitStages() const {return 2;}
     virtual void initialize(int stage);
     virtual void handleMessage(omnetpp::cMessage *msg);
@@ -14,52 +14,93 @@
  *******************************************************************************/
 #include "Configuration.h"
 #include <typeinfo>
+#include <assert.h>
 #include <modules/LoadBalancer.h>
 #include <modules/MTServerType.h>
 //    int brownoutLevel = 1 + (pModel->getNumberOfBrownoutLevels() - 1) * pModel->getConfiguration().getBrownOutFactor();
 
 
-Configuration::Configuration() : 
-        serversA(0), serversB(0), serversC(0),
-        bootRemain(0), 
-        bootServerType(MTServerType::NONE), 
+Configuration::Configuration() :
+        totalServers(0),
+        totalBooting(0),
+        bootRemain(0),
+        bootServerType(MTServerType::NONE),
+        brownoutLevel(0) {}
+
+Configuration::Configuration(unsigned serverTypes) :
+        servers(serverTypes + 1, 0),
+        totalServers(0),
+        booting(serverTypes + 1, 0),
+        totalBooting(0),
+        bootRemain(0),
+        bootServerType(MTServerType::NONE),
         brownoutLevel(0),
-        trafficA(LoadBalancer::TrafficLoad::HUNDRED),
-        trafficB(LoadBalancer::TrafficLoad::ZERO), 
-        trafficC(LoadBalancer::TrafficLoad::ZERO) {}
+        traffic(serverTypes + 1, LoadBalancer::TrafficLoad::ZERO) {
+    if (serverTypes > 0) {
+        traffic[MTServerType::NONE + 1] = LoadBalancer::TrafficLoad::HUNDRED;
+    }
+}
 
-Configuration::Configuration(int serverA, int serverB, int serverC,
+Configuration::Configuration(const std::vector<int>& servers,
         int bootRemain, MTServerType::ServerType serverType,
-        int brownoutLevel, LoadBalancer::TrafficLoad trafficA, 
-        LoadBalancer::TrafficLoad trafficB, LoadBalancer::TrafficLoad trafficC) :
-        serversA(serverA), serversB(serverB), serversC(serverC),
+        int brownoutLevel, const std::vector<LoadBalancer::TrafficLoad>& traffic) :
+        servers(servers), totalServers(0), totalBooting(0),
                 bootRemain(bootRemain), bootServerType(serverType),
-                brownoutLevel(brownoutLevel), trafficA(trafficA),
-                trafficB(trafficB), trafficC(trafficC) {};
+                brownoutLevel(brownoutLevel), traffic(traffic) {
+    if (this->servers.empty()) {
+        this->servers.push_back(0);
+    }
+    this->servers[MTServerType::NONE] = 0;
+    for (int count : this->servers) {
+        totalServers += count;
+    }
+    booting.assign(this->servers.size(), 0);
+    if (bootRemain > 0 && serverType != MTServerType::NONE) {
+        booting[serverType] = 1;
+        totalBooting = 1;
+    }
+    if (this->traffic.empty()) {
+        this->traffic.assign(this->servers.size(), LoadBalancer::TrafficLoad::ZERO);
+        if (this->traffic.size() > 1) {
+            this->traffic[MTServerType::NONE + 1] = LoadBalancer::TrafficLoad::HUNDRED;
+        }
+    }
+    assert(this->traffic.size() == this->servers.size());
+};
+
 
+unsigned Configuration::getNumberOfServerTypes() const {
+    return servers.empty() ? 0 : servers.size() - 1;
+}
 
 int Configuration::getBootRemain() const {
     return bootRemain;
 }
 
 int Configuration::getServers(MTServerType::ServerType type) const {
-    int cntServers;
-
-    switch (type) {
-    case MTServerType::ServerType::POWERFUL:
-        cntServers = this->serversA + ((bootServerType == MTServerType::ServerType::POWERFUL) ? 1 : 0);
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        cntServers = this->serversB + ((bootServerType == MTServerType::ServerType::AVERAGE) ? 1 : 0);
-        break;
-    case MTServerType::ServerType::WEAK:
-        cntServers = this->serversC + ((bootServerType == MTServerType::ServerType::WEAK) ? 1 : 0);
-        break;
-    case MTServerType::ServerType::NONE:
-        cntServers = 0;
+    if (type == MTServerType::ServerType::NONE) {
+        return 0;
     }
+    assert(type < (int) servers.size());
+    return servers[type] + booting[type];
+}
 
-    return cntServers;
+int Configuration::getBootingServers(MTServerType::ServerType serverType) const {
+    if (serverType == MTServerType::ServerType::NONE) {
+        return 0;
+    }
+    assert(serverType < (int) booting.size());
+    return booting[serverType];
+}
+
+void Configuration::setBootingServers(int servers, MTServerType::ServerType serverType) {
+    assert(serverType != MTServerType::ServerType::NONE && serverType < (int) booting.size());
+    totalBooting += servers - booting[serverType];
+    booting[serverType] = servers;
+}
+
+int Configuration::getTotalBootingServers() const {
+    return totalBooting;
 }
 
 MTServerType::ServerType Configuration::getBootType() const {
@@ -85,80 +126,29 @@ void Configuration::setBrownOutLevel(int brownoutLevel) {
 }
 
 int Configuration::getActiveServers(MTServerType::ServerType serverType) const {
-    int cntServer;
-
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        cntServer = this->serversA;
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        cntServer = this->serversB;
-        break;
-    case MTServerType::ServerType::WEAK:
-        cntServer = this->serversC;
-        break;
-    case MTServerType::ServerType::NONE:
-        cntServer = 0;
+    if (serverType == MTServerType::ServerType::NONE) {
+        return 0;
     }
-
-    return cntServer;
+    assert(serverType < (int) servers.size());
+    return servers[serverType];
 }
 
 void Configuration::setActiveServers(int servers, MTServerType::ServerType serverType) {
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        this->serversA = servers;
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        this->serversB = servers;
-        break;
-    case MTServerType::ServerType::WEAK:
-        this->serversC = servers;
-        break;
-    case MTServerType::ServerType::NONE:
-        assert(false);
-    }
-
-    this->bootRemain = 0;
-    this->bootServerType = MTServerType::ServerType::NONE;
+    assert(serverType != MTServerType::ServerType::NONE && serverType < (int) this->servers.size());
+    totalServers += servers - this->servers[serverType];
+    this->servers[serverType] = servers;
 }
 
 LoadBalancer::TrafficLoad Configuration::getTraffic(MTServerType::ServerType serverType) const {
-    LoadBalancer::TrafficLoad traffic = LoadBalancer::TrafficLoad::INVALID;
-
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        traffic = this->trafficA;
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        traffic = this->trafficB;
-        break;
-    case MTServerType::ServerType::WEAK:
-        traffic = this->trafficC;
-        break;
-    case MTServerType::ServerType::NONE:
-        assert(false);
-    }
-
-    return traffic;
+    assert(serverType != MTServerType::ServerType::NONE && serverType < (int) traffic.size());
+    return traffic[serverType];
 }
 
 void Configuration::setTraffic(MTServerType::ServerType serverType, LoadBalancer::TrafficLoad trafficLoad) {
-    switch (serverType) {
-        case MTServerType::ServerType::POWERFUL:
-            this->trafficA = trafficLoad;
-            break;
-        case MTServerType::ServerType::AVERAGE:
-            this->trafficB = trafficLoad;
-            break;
-        case MTServerType::ServerType::WEAK:
-            this->trafficC = trafficLoad;
-            break;
-        case MTServerType::ServerType::NONE:
-            assert(false);
-        }
+    assert(serverType != MTServerType::ServerType::NONE && serverType < (int) traffic.size());
+    traffic[serverType] = trafficLoad;
 }
 
 int Configuration::getTotalActiveServers() const {
-    return this->serversA + this->serversB + this->serversC;
+    return totalServers;
 }
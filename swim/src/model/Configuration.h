@@ -19,26 +19,44 @@
 #include <modules/MTServerType.h>
 #include <modules/LoadBalancer.h>
 #include <ostream>
+#include <vector>
 
+/**
+ * Configuration of the system. Server counts and traffic loads are kept in
+ * dense vectors indexed by server type id (MTServerType::ServerType), so
+ * that any number of server types can be declared. Index 0 (NONE) is
+ * never used.
+ */
 class Configuration : public pladapt::Configuration {
-    int serversA; // number of active servers (there is one more powered up if bootRemain > 0
-    int serversB;
-    int serversC;
-    int bootRemain; // how many periods until we have one more server. If 0, no server is booting
-    // true if the cache of the last added server is cold
+    std::vector<int> servers; // number of active servers of each type
+    int totalServers; // sum of servers
+    std::vector<int> booting; // number of servers of each type being booted
+    int totalBooting; // sum of booting
+    int bootRemain; // how many periods until the next booting server is active. If 0, no server is booting
+    // type of the next server to become active
     MTServerType::ServerType bootServerType;
     int brownoutLevel;
 
-    LoadBalancer::TrafficLoad trafficA;
-    LoadBalancer::TrafficLoad trafficB;
-    LoadBalancer::TrafficLoad trafficC;
+    std::vector<LoadBalancer::TrafficLoad> traffic; // traffic load of each type
 public:
     Configuration();
-    Configuration(int serverA, int serverB, int serverC, int bootRemain, MTServerType::ServerType serverType, 
-    int brownoutLevel, 
-    LoadBalancer::TrafficLoad trafficA = LoadBalancer::TrafficLoad::HUNDRED,
-    LoadBalancer::TrafficLoad trafficB = LoadBalancer::TrafficLoad::ZERO,
-    LoadBalancer::TrafficLoad trafficC = LoadBalancer::TrafficLoad::ZERO);
+
+    /**
+     * Creates a configuration with no servers, in which the first type
+     * gets all the traffic
+     *
+     * @param serverTypes number of server types (excluding NONE)
+     */
+    explicit Configuration(unsigned serverTypes);
+
+    /**
+     * @param servers active servers indexed by server type id
+     * @param traffic traffic load indexed by server type id, if empty the
+     *  first type gets all the traffic
+     */
+    Configuration(const std::vector<int>& servers, int bootRemain, MTServerType::ServerType serverType,
+            int brownoutLevel,
+            const std::vector<LoadBalancer::TrafficLoad>& traffic = std::vector<LoadBalancer::TrafficLoad>());
 
 //    virtual bool operator==(const Configuration& other) const;
 //    virtual void printOn(std::ostream& os) const;
@@ -47,6 +65,7 @@ public:
 //    friend std::ostream& operator<<(std::ostream& os, const Configuration& config);
 
 
+    unsigned getNumberOfServerTypes() const;
     MTServerType::ServerType getBootType() const;
     int getBootRemain() const;
     void setBootRemain(int bootRemain, MTServerType::ServerType = MTServerType::ServerType::NONE);
@@ -54,7 +73,14 @@ public:
     void setBrownOutLevel(int brownoutLevel);
     int getActiveServers(MTServerType::ServerType) const;
     void setActiveServers(int servers, MTServerType::ServerType);
+
+    /**
+     * @return active plus booting servers of the given type
+     */
     int getServers(MTServerType::ServerType serverType) const;
+    int getBootingServers(MTServerType::ServerType serverType) const;
+    void setBootingServers(int servers, MTServerType::ServerType serverType);
+    int getTotalBootingServers() const;
     LoadBalancer::TrafficLoad getTraffic(MTServerType::ServerType serverType) const;
     void setTraffic(MTServerType::ServerType serverType, LoadBalancer::TrafficLoad trafficLoad);
     int getTotalActiveServers() const;
@@ -14,10 +14,11 @@
  *******************************************************************************/
 #include "Environment.h"
 
-Environment::Environment() : arrivalMean(0), arrivalVariance(0) {}
+Environment::Environment() : arrivalMean(0), arrivalVariance(0), arrivalRateForecast(0), arrivalRateStdDev(0) {}
 
 Environment::Environment(double arrivalMean, double arrivalStdDev)
-    : arrivalMean(arrivalMean), arrivalVariance(arrivalStdDev) {};
+    : arrivalMean(arrivalMean), arrivalVariance(arrivalStdDev),
+      arrivalRateForecast((arrivalMean > 0) ? 1 / arrivalMean : 0), arrivalRateStdDev(0) {};
 
 double Environment::getArrivalMean() const {
     return arrivalMean;
@@ -35,8 +36,25 @@ void Environment::setArrivalVariance(double arrivalVariance) {
     this->arrivalVariance = arrivalVariance;
 }
 
+double Environment::getArrivalRateForecast() const {
+    return arrivalRateForecast;
+}
+
+void Environment::setArrivalRateForecast(double arrivalRateForecast) {
+    this->arrivalRateForecast = arrivalRateForecast;
+}
+
+double Environment::getArrivalRateStdDev() const {
+    return arrivalRateStdDev;
+}
+
+void Environment::setArrivalRateStdDev(double arrivalRateStdDev) {
+    this->arrivalRateStdDev = arrivalRateStdDev;
+}
+
 void Environment::printOn(std::ostream& os) const {
-    os << "environment[interArrival mean=" << arrivalMean << ", variance=" << arrivalVariance << "]";
+    os << "environment[interArrival mean=" << arrivalMean << ", variance=" << arrivalVariance
+            << ", rate forecast=" << arrivalRateForecast << "]";
 }
 
 std::ostream& operator<<(std::ostream& os, const Environment& env) {
@@ -22,6 +22,8 @@
 class Environment : public pladapt::Environment {
     double arrivalMean;
     double arrivalVariance;
+    double arrivalRateForecast; /**< short-horizon forecast of the arrival rate (requests/s) */
+    double arrivalRateStdDev; /**< standard deviation of the arrival rate (for predicted environments) */
 public:
     Environment();
     Environment(double arrivalMean, double arrivalVariance);
@@ -30,6 +32,16 @@ public:
     void setArrivalMean(double arrivalMean);
     double getArrivalVariance() const;
     void setArrivalVariance(double arrivalVariance);
+    double getArrivalRateForecast() const;
+    void setArrivalRateForecast(double arrivalRateForecast);
+
+    /**
+     * For predicted environments, standard deviation of the forecast error
+     * of the arrival rate, so that a prediction interval is, e.g.,
+     * getArrivalRateForecast() +/- 1.96 * getArrivalRateStdDev()
+     */
+    double getArrivalRateStdDev() const;
+    void setArrivalRateStdDev(double arrivalRateStdDev);
 
     virtual double asDouble() const;
 };
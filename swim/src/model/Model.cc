@@ -17,12 +17,14 @@
 #include <managers/execution/ExecutionManagerModBase.h>
 #include "modules/PredictableRandomSource.h"
 #include <sstream>
+#include <algorithm>
 #include <math.h>
 #include <iostream>
 #include <assert.h>
 #include <util/Utils.h>
 
 using namespace std;
+using namespace omnetpp;
 
 #define LOCDEBUG 0
 
@@ -31,37 +33,50 @@ Define_Module(Model);
 const char* Model::HORIZON_PAR = "horizon";
 
 Model::Model()
-    : activeServerCountLast(0), timeActiveServerCountLast(0.0), activeServers(0)
+    : activeServerCountLast(0), timeActiveServerCountLast(0.0)
 {
 }
 
 Model::~Model() {
 }
 
-void Model::addExpectedChange(double time, ModelChange change)
+void Model::addExpectedChange(double time, ModelChange change, MTServerType::ServerType serverType, int serverId, bool ramp)
 {
     ModelChangeEvent event;
     event.startTime = simTime().dbl();
     event.time = time;
     event.change = change;
-    events.insert(event);
+    event.serverType = serverType;
+    event.serverId = serverId;
+    event.ramp = ramp;
+
+    // insert after the events with the same time to keep the insertion order
+    ModelChangeEvents& timeline = events[serverType];
+    timeline.insert(upper_bound(timeline.begin(), timeline.end(), event, ModelChangeEventComp()), event);
 }
 
-void Model::removeExpectedChange()
+bool Model::removeExpectedChange(MTServerType::ServerType serverType, int serverId)
 {
-    if (!events.empty()) {
-        events.erase(--events.end());
-    } else {
-        std::cout << "removeExpectedChange(): serverCount "
-                << configuration.getTotalActiveServers() << " activeServerCount "<< std::endl;
+    ModelChangeEvents& timeline = events[serverType];
+    ModelChangeEvents::iterator it = find_if(timeline.begin(), timeline.end(),
+            [serverId](const ModelChangeEvent& event) { return event.serverId == serverId; });
+    if (it == timeline.end()) {
+        std::cout << "removeExpectedChange(): no expected change for server " << serverId << std::endl;
+        return false;
     }
+    timeline.erase(it);
+    return true;
+}
+
+void Model::updateBootingServers(MTServerType::ServerType serverType) {
+    configuration.setBootingServers(events[serverType].size(), serverType);
 }
 
 int Model::getDimmerLevel() const {
     return 1 + (numberOfBrownoutLevels - 1) * configuration.getBrownOutLevel();
 }
 
-int Model::getActiveServerCountIn(double deltaTime, MTServerType::ServerType serverType)
+double Model::getActiveServerCountIn(double deltaTime, MTServerType::ServerType serverType)
 {
     /*
      * We don't keep a past history, but if we need to know what was the active
@@ -72,113 +87,162 @@ int Model::getActiveServerCountIn(double deltaTime, MTServerType::ServerType ser
         return (timeActiveServerCountLast < simTime().dbl()) ? configuration.getActiveServers(serverType) : serverInfo->activeServerCountLast;
     }
 
-    int servers = configuration.getActiveServers(serverType);
+    double time = simTime().dbl() + deltaTime;
+    double servers = configuration.getActiveServers(serverType);
 
-    double currentTime = simTime().dbl();
-    ModelChangeEvents::iterator it = events.begin();
-    while (it != events.end() && it->time <= currentTime + deltaTime) {
-        if (it->change == getOnlineEventCode(serverType)) {
-            servers++;
-        }
-        it++;
+    // active servers that will not have reached full capacity yet
+    for (const auto& rampStart : serverInfo->rampStarts) {
+        servers -= 1.0 - getRampCapacity(*serverInfo, rampStart.second, time);
+    }
+
+    // all the changes in the timeline are SERVER_ONLINE, so we just count them
+    ModelChangeEvent until;
+    until.time = time;
+    const ModelChangeEvents& timeline = events[serverType];
+    ModelChangeEvents::const_iterator last = upper_bound(timeline.begin(), timeline.end(), until, ModelChangeEventComp());
+    for (ModelChangeEvents::const_iterator it = timeline.begin(); it != last; ++it) {
+        servers += it->ramp ? getRampCapacity(*serverInfo, it->time, time) : 1.0;
     }
 
     return servers;
 }
 
-void Model::setTrafficLoad(LoadBalancer::TrafficLoad serverA,
-              LoadBalancer::TrafficLoad serverB, LoadBalancer::TrafficLoad serverC) {
-    this->configuration.setTraffic(MTServerType::ServerType::POWERFUL, serverA);
-    this->configuration.setTraffic(MTServerType::ServerType::AVERAGE, serverB);
-    this->configuration.setTraffic(MTServerType::ServerType::WEAK, serverC);
+double Model::getRampCapacity(const ServerInfo& info, double activationTime, double time) const {
+    double elapsed = time - activationTime;
+    if (info.rampDuration <= 0 || elapsed >= info.rampDuration) {
+        return 1.0;
+    }
+    return info.rampInitialCapacity + (1.0 - info.rampInitialCapacity) * max(0.0, elapsed) / info.rampDuration;
+}
+
+void Model::setTrafficLoad(const std::vector<LoadBalancer::TrafficLoad>& traffic) {
+    ASSERT(traffic.size() == serverInfo.size());
+    for (unsigned type = MTServerType::NONE + 1; type < traffic.size(); type++) {
+        this->configuration.setTraffic(MTServerType::ServerType(type), traffic[type]);
+    }
 }
 
-void Model::addServer(double bootDelay, MTServerType::ServerType serverType)
+void Model::addServer(double bootDelay, MTServerType::ServerType serverType, int serverId, bool ramp)
 {
-    ASSERT(!isServerBooting()); // only one add server tactic at a time
-    addExpectedChange(simTime().dbl() + bootDelay, getOnlineEventCode(serverType));
-    configuration.setBootRemain(ceil(bootDelay / evaluationPeriod), serverType);
+    addExpectedChange(simTime().dbl() + bootDelay, SERVER_ONLINE, serverType, serverId, ramp);
+    updateBootingServers(serverType);
     lastConfigurationUpdate = simTime();
 
 #if LOCDEBUG
-    std::cout << simTime().dbl() << ": " << "addServer(" << bootDelay << "): serverCount=" << getServers() << " active=" << activeServers << " expected=" << events.size() << std::endl;
+    std::cout << simTime().dbl() << ": " << "addServer(" << bootDelay << "): serverCount=" << getServers() << " active=" << getActiveServers() << " expected=" << events[serverType].size() << std::endl;
 #endif
 }
 
 
-void Model::serverBecameActive(MTServerType::ServerType serverType)
+void Model::serverBecameActive(MTServerType::ServerType serverType, int serverId)
 {
     ServerInfo* serverInfo = const_cast<ServerInfo* >(getServerInfoObj(serverType));
     serverInfo->activeServerCountLast = configuration.getActiveServers(serverType);
     timeActiveServerCountLast = simTime().dbl();
 
-    /* remove expected change...assume it is the first SERVER_ONLINE */
-    Model::ModelChange serverBootupEventCode = getOnlineEventCode(serverType);
-    ModelChangeEvents::iterator it = events.begin();
-    while (it != events.end() && it->change != serverBootupEventCode) {
-        it++;
+    /* remove the expected change of this server, which is not always the first if boot delays are random */
+    ModelChangeEvents& timeline = events[serverType];
+    ModelChangeEvents::iterator it = find_if(timeline.begin(), timeline.end(),
+            [serverId](const ModelChangeEvent& event) { return event.serverId == serverId; });
+    assert(it != timeline.end()); // there must be an expected change for this
+    bool ramp = it->ramp;
+    timeline.erase(it);
+
+    // forget the servers that have reached full capacity, and add this one if it has to ramp up
+    map<int, double>& rampStarts = serverInfo->rampStarts;
+    double now = simTime().dbl();
+    for (map<int, double>::iterator rampIt = rampStarts.begin(); rampIt != rampStarts.end();) {
+        if (now - rampIt->second >= serverInfo->rampDuration) {
+            rampIt = rampStarts.erase(rampIt);
+        } else {
+            ++rampIt;
+        }
+    }
+    if (ramp && serverInfo->rampDuration > 0) {
+        rampStarts[serverId] = now;
     }
-    assert(it != events.end()); // there must be an expected change for this
-    events.erase(it);
 
     configuration.setActiveServers(serverInfo->activeServerCountLast + 1, serverType);
-    configuration.setBootRemain(0);
+    updateBootingServers(serverType);
     lastConfigurationUpdate = simTime();
 
 #if LOCDEBUG
-    std::cout << simTime().dbl() << ": " << "serverBecameActive(): serverCount=" << getServers() << " active=" << activeServers << " expected=" << events.size() << std::endl;
-    if (events.size() > 0) {
-        cout << simTime().dbl() << "expected event time=" << events.begin()->time
-                << string(((events.begin()->time > simTime().dbl()) ? " > " : " <= "))
+    std::cout << simTime().dbl() << ": " << "serverBecameActive(): serverCount=" << getServers() << " active=" << getActiveServers() << " expected=" << timeline.size() << std::endl;
+    if (timeline.size() > 0) {
+        cout << simTime().dbl() << "expected event time=" << timeline.begin()->time
+                << string(((timeline.begin()->time > simTime().dbl()) ? " > " : " <= "))
                         << " current time" << endl;
     }
 #endif
 
 }
 
-Model::ModelChange Model::getOnlineEventCode(MTServerType::ServerType serverType) const {
-    ModelChange event = INVALID;
+void Model::cancelServerBoot(MTServerType::ServerType serverType, int serverId)
+{
 
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        event = SERVERA_ONLINE;
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        event = SERVERB_ONLINE;
-        break;
-    case MTServerType::ServerType::WEAK:
-        event = SERVERC_ONLINE;
-        break;
-    case MTServerType::ServerType::NONE:
-        assert(false);
-    }
+    /* the server we're removing is not active yet */
+    removeExpectedChange(serverType, serverId);
+    updateBootingServers(serverType);
+    lastConfigurationUpdate = simTime();
+}
 
-    return event;
+void Model::serverDraining(MTServerType::ServerType serverType)
+{
+    ASSERT(drainingServers[serverType] < configuration.getActiveServers(serverType));
+    drainingServers[serverType]++;
+}
+
+int Model::getDrainingServers(MTServerType::ServerType serverType) const {
+    return drainingServers[serverType];
 }
 
-void Model::removeServer(MTServerType::ServerType serverType)
+int Model::getTotalDrainingServers() const {
+    int total = 0;
+    for (int draining : drainingServers) {
+        total += draining;
+    }
+    return total;
+}
+
+void Model::removeServer(MTServerType::ServerType serverType, int serverId)
 {
-    if (isServerBooting()) {
+    ServerInfo* serverInfo = const_cast<ServerInfo*>(getServerInfoObj(serverType));
+    serverInfo->activeServerCountLast = configuration.getActiveServers(serverType);
+    timeActiveServerCountLast = simTime().dbl();
 
-        /* the server we're removing is not active yet */
-        removeExpectedChange();
-        configuration.setBootRemain(0);
-    } else {
-        ServerInfo* serverInfo = const_cast<ServerInfo*>(getServerInfoObj(serverType));
-        serverInfo->activeServerCountLast = configuration.getActiveServers(serverType);
-        timeActiveServerCountLast = simTime().dbl();
+    configuration.setActiveServers(serverInfo->activeServerCountLast - 1, serverType);
 
-        configuration.setActiveServers(serverInfo->activeServerCountLast - 1, serverType);
+    // nothing to forget if the server had reached full capacity
+    serverInfo->rampStarts.erase(serverId);
+    if (drainingServers[serverType] > 0) {
+        drainingServers[serverType]--;
     }
     lastConfigurationUpdate = simTime();
     std::cout << "Server removed: " << serverType << std::endl;
 
 #if LOCDEBUG
-    std::cout << simTime().dbl() << ": " << "removeServer(): serverCount=" << getServers() << " active=" << activeServers << " expected=" << events.size() << std::endl;
+    std::cout << simTime().dbl() << ": " << "removeServer(): serverCount=" << getServers() << " active=" << getActiveServers() << " expected=" << events[serverType].size() << std::endl;
 #endif
 
 }
 
+void Model::serverSuspended(MTServerType::ServerType serverType, int serverId)
+{
+    removeServer(serverType, serverId);
+    suspendedServers[serverType]++;
+}
+
+void Model::resumeServer(double resumeDelay, MTServerType::ServerType serverType, int serverId)
+{
+    ASSERT(suspendedServers[serverType] > 0);
+    suspendedServers[serverType]--;
+    addServer(resumeDelay, serverType, serverId);
+}
+
+int Model::getSuspendedServers(MTServerType::ServerType serverType) const {
+    return suspendedServers[serverType];
+}
+
 void Model::setBrownoutFactor(int factor) {
     configuration.setBrownOutLevel(factor);
 }
@@ -196,116 +260,121 @@ double Model::getDimmerFactor() const {
 }
 
 int const Model::getActiveServers() const {
-    return activeServers;
+    return configuration.getTotalActiveServers();
 }
 
 int const Model::getServers() const {
-    return (isServerBooting() ? activeServers + 1 : activeServers);
+    return configuration.getTotalActiveServers() + configuration.getTotalBootingServers();
 }
 
 void Model::initialize(int stage) {
     if (stage == 0) {
         // get parameters
-        serverA.maxServers = omnetpp::getSimulation()->getSystemModule()->par("maxServersA");
-        serverB.maxServers = omnetpp::getSimulation()->getSystemModule()->par("maxServersB");
-        serverC.maxServers = omnetpp::getSimulation()->getSystemModule()->par("maxServersC");
-        int maxServers = serverA.maxServers + serverB.maxServers + serverC.maxServers;
-        evaluationPeriod = getSimulation()->getSystemModule()->par("evaluationPeriod").doubleValue();
-        bootDelay = Utils::getMeanAndVarianceFromParameter(
-                                getSimulation()->getSystemModule()->par("bootDelay"));
-
-        horizon = max(5.0,ceil(bootDelay / evaluationPeriod) * (maxServers - 1) + 1);
+        cModule* system = getSimulation()->getSystemModule();
+
+        /*
+         * server types are declared by name, and get ids starting at 1 in
+         * the order they are declared
+         */
+        vector<string> typeNames = cStringTokenizer(system->par("serverTypes").stringValue()).asVector();
+        if (typeNames.empty()) {
+            error("serverTypes must declare at least one server type");
+        }
+        vector<int> maxServersPerType = cStringTokenizer(system->par("maxServersPerType").stringValue()).asIntVector();
+        vector<int> initialServersPerType = cStringTokenizer(system->par("initialServersPerType").stringValue()).asIntVector();
+        if (maxServersPerType.empty()) {
+            maxServersPerType.assign(typeNames.size(), system->par("maxServers").intValue());
+        }
+        if (initialServersPerType.empty()) {
+
+            // all the initial servers are of the first type
+            initialServersPerType.assign(typeNames.size(), 0);
+            initialServersPerType[0] = system->par("initialServers").intValue();
+        }
+        if (maxServersPerType.size() != typeNames.size()) {
+            error("maxServersPerType must have one value per server type");
+        }
+        if (initialServersPerType.size() != typeNames.size()) {
+            error("initialServersPerType must have one value per server type");
+        }
+
+        serverInfo.assign(typeNames.size() + 1, ServerInfo());
+        serverTypeIds.clear();
+        for (unsigned i = 0; i < typeNames.size(); i++) {
+            MTServerType::ServerType type = MTServerType::ServerType(MTServerType::NONE + 1 + i);
+            if (!serverTypeIds.insert(make_pair(typeNames[i], type)).second) {
+                error("server type %s declared more than once", typeNames[i].c_str());
+            }
+            if (initialServersPerType[i] > maxServersPerType[i]) {
+                error("initial servers of type %s exceed its maximum", typeNames[i].c_str());
+            }
+            serverInfo[type].name = typeNames[i];
+            serverInfo[type].maxServers = maxServersPerType[i];
+            serverInfo[type].initialServers = initialServersPerType[i];
+        }
+        configuration = Configuration(typeNames.size());
+        events.assign(serverInfo.size(), ModelChangeEvents());
+        drainingServers.assign(serverInfo.size(), 0);
+        suspendedServers.assign(serverInfo.size(), 0);
+
+        evaluationPeriod = system->par("evaluationPeriod").doubleValue();
+        bootDelay = Utils::getMeanAndVarianceFromParameter(system->par("bootDelay"));
+
+
+        // < 0 to derive it from the boot delays in getHorizon()
+        horizon = -1;
         if (hasPar(HORIZON_PAR)) {
             horizon = par("horizon");
         }
-        if (horizon < 0) {
-            horizon = max(5.0, ceil(bootDelay / evaluationPeriod) * (maxServers - 1) + 1);
-        }
 
-        numberOfBrownoutLevels = getSimulation()->getSystemModule()->par("numberOfBrownoutLevels");
-        dimmerMargin = getSimulation()->getSystemModule()->par("dimmerMargin");
+        numberOfBrownoutLevels = system->par("numberOfBrownoutLevels");
+        dimmerMargin = system->par("dimmerMargin");
         lowerDimmerMargin = par("lowerDimmerMargin");
     } else {
         // start servers
         ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
-        int initialServers = omnetpp::getSimulation()->getSystemModule()->par("initialServersA");
-        while (initialServers > 0) {
-            pExecMgr->addServerLatencyOptional(MTServerType::ServerType::POWERFUL, true);
-            initialServers--;
-        }
-        initialServers = omnetpp::getSimulation()->getSystemModule()->par( "initialServersB");
-        while (initialServers > 0) {
-            pExecMgr->addServerLatencyOptional(MTServerType::ServerType::AVERAGE, true);
-            initialServers--;
-        }
-        initialServers = omnetpp::getSimulation()->getSystemModule()->par("initialServersC");
-        while (initialServers > 0) {
-            pExecMgr->addServerLatencyOptional(MTServerType::ServerType::WEAK, true);
-            initialServers--;
+        for (unsigned type = MTServerType::NONE + 1; type < serverInfo.size(); type++) {
+            int initialServers = serverInfo[type].initialServers;
+            while (initialServers > 0) {
+                pExecMgr->addServerLatencyOptional(MTServerType::ServerType(type), true);
+                initialServers--;
+            }
         }
     }
 }
 
 bool Model::isServerBooting(MTServerType::ServerType serverType) const {
-    bool isBooting = false;
-
-    if (!events.empty()) {
-        ModelChangeEvents::const_iterator eventIt = events.begin();
-        if (eventIt != events.end()) {
-            ModelChange changeEventCode = getOnlineEventCode(serverType);
-            ASSERT(eventIt->change == changeEventCode);
-            isBooting = true;
-            eventIt++;
-            ASSERT(eventIt == events.end()); // only one tactic should be active
-        }
-    }
-
-    return isBooting;
+    return configuration.getBootingServers(serverType) > 0;
 }
 
 bool Model::isServerBooting() const {
-    bool isBooting = false;
-
-    if (!events.empty()) {
-
-        /* find if a server is booting. Assume only one can be booting */
-        ModelChangeEvents::const_iterator eventIt = events.begin();
-        if (eventIt != events.end()) {
-            ModelChange changeEventCodeServerA = getOnlineEventCode(MTServerType::ServerType::POWERFUL);
-            ModelChange changeEventCodeServerB = getOnlineEventCode(MTServerType::ServerType::AVERAGE);
-            ModelChange changeEventCodeServerC = getOnlineEventCode(MTServerType::ServerType::WEAK);
-            ASSERT(eventIt->change == changeEventCodeServerA || eventIt->change == changeEventCodeServerB || eventIt->change == changeEventCodeServerC);
-            isBooting = true;
-            eventIt++;
-            ASSERT(eventIt == events.end()); // only one tactic should be active
-        }
-    }
-    return isBooting;
+    return configuration.getTotalBootingServers() > 0;
 }
 
 
 Configuration Model::getConfiguration() {
-    Configuration configuration;
+    Configuration configuration = this->configuration;
 
-    if (events.empty()) {
+    /* find the booting server that will be active first */
+    const ModelChangeEvent* first = nullptr;
+    for (const auto& timeline : events) {
+        if (!timeline.empty() && (first == nullptr || timeline.front().time < first->time)) {
+            first = &timeline.front();
+        }
+    }
+
+    if (first == nullptr) {
         configuration.setBootRemain(0);
     } else {
-
-        /* find if a server is booting. Assume only one can be booting */
-        ModelChangeEvents::const_iterator eventIt = events.begin();
-        if (eventIt != events.end()) {
-            ASSERT(eventIt->change == SERVER_ONLINE);
-            int bootRemain = ceil((eventIt->time - simTime().dbl()) / evaluationPeriod);
-
-            /*
-             * we never set boot remain to 0 here because the server could
-             * still be booting (if we allowed random boot times)
-             * so, we keep it > 0, and only serverBecameActive() can set it to 0
-             */
-            configuration.setBootRemain(std::max(1, bootRemain));
-            eventIt++;
-            ASSERT(eventIt == events.end()); // only one tactic should be active
-        }
+        ASSERT(first->change == SERVER_ONLINE);
+        int bootRemain = ceil((first->time - simTime().dbl()) / evaluationPeriod);
+
+        /*
+         * we never set boot remain to 0 here because the server could
+         * still be booting (if we allowed random boot times)
+         * so, we keep it > 0, and only serverBecameActive() can set it to 0
+         */
+        configuration.setBootRemain(std::max(1, bootRemain), first->serverType);
     }
     return configuration;
 }
@@ -318,28 +387,34 @@ void Model::setEnvironment(const Environment& environment) {
     this->environment = environment;
 }
 
+const EnvironmentVector& Model::getEnvironmentForecast() const {
+    return environmentForecast;
+}
+
+void Model::setEnvironmentForecast(const EnvironmentVector& environmentForecast) {
+    this->environmentForecast = environmentForecast;
+}
+
 int Model::getMaxServers(MTServerType::ServerType serverType) const {
     return getServerInfoObj(serverType)->maxServers;
 }
 
-const Model::ServerInfo* Model::getServerInfoObj(MTServerType::ServerType serverType) const {
-    const ServerInfo* serverInfo = NULL;
-
-    switch (serverType) {
-    case MTServerType::ServerType::POWERFUL:
-        serverInfo = &serverA;
-        break;
-    case MTServerType::ServerType::AVERAGE:
-        serverInfo = &serverB;
-        break;
-    case MTServerType::ServerType::WEAK:
-        serverInfo = &serverC;
-        break;
-    case MTServerType::ServerType::NONE:
-        assert(false);
-    }
+unsigned Model::getNumberOfServerTypes() const {
+    return serverInfo.empty() ? 0 : serverInfo.size() - 1;
+}
 
-    return serverInfo;
+const std::string& Model::getServerTypeName(MTServerType::ServerType serverType) const {
+    return getServerInfoObj(serverType)->name;
+}
+
+MTServerType::ServerType Model::getServerType(const std::string& name) const {
+    auto it = serverTypeIds.find(name);
+    return (it != serverTypeIds.end()) ? it->second : MTServerType::NONE;
+}
+
+const Model::ServerInfo* Model::getServerInfoObj(MTServerType::ServerType serverType) const {
+    assert(serverType > MTServerType::NONE && serverType < (int) serverInfo.size());
+    return &serverInfo[serverType];
 }
 
 double Model::getAvgResponseTime() const {
@@ -363,8 +438,39 @@ double Model::getBootDelay() const {
     return bootDelay;
 }
 
+double Model::getBootDelay(MTServerType::ServerType serverType) const {
+    double typeBootDelay = getServerInfoObj(serverType)->bootDelay;
+    return (typeBootDelay >= 0) ? typeBootDelay : bootDelay;
+}
+
+void Model::setBootDelay(double bootDelay, MTServerType::ServerType serverType) {
+    ServerInfo* serverInfo = const_cast<ServerInfo*>(getServerInfoObj(serverType));
+    serverInfo->bootDelay = bootDelay;
+}
+
+void Model::setRamp(double duration, double initialCapacity, MTServerType::ServerType serverType) {
+    ServerInfo* serverInfo = const_cast<ServerInfo*>(getServerInfoObj(serverType));
+    serverInfo->rampDuration = duration;
+    serverInfo->rampInitialCapacity = initialCapacity;
+}
+
 int Model::getHorizon() const {
-    return horizon;
+    if (horizon >= 0) {
+        return horizon;
+    }
+
+    /*
+     * long enough to boot all the servers one after the other with the
+     * slowest server type. The per-type boot delays are only set when the
+     * first server of each type is added, so this is not done in initialize()
+     */
+    double maxBootDelay = 0;
+    int maxServers = 0;
+    for (unsigned type = MTServerType::NONE + 1; type < serverInfo.size(); type++) {
+        maxBootDelay = max(maxBootDelay, getBootDelay(MTServerType::ServerType(type)));
+        maxServers += serverInfo[type].maxServers;
+    }
+    return max(5.0, ceil(maxBootDelay / evaluationPeriod) * (maxServers - 1) + 1);
 }
 
 int Model::getNumberOfBrownoutLevels() const {
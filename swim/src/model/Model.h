@@ -18,6 +18,9 @@
 
 #include <omnetpp.h>
 #include <set>
+#include <map>
+#include <vector>
+#include <string>
 #include "Configuration.h"
 #include "Environment.h"
 #include "Observations.h"
@@ -31,12 +34,15 @@ public:
      * the type of change, so if a new change type is added, those methods
      * would have to be fixed
      */
-    enum ModelChange { SERVERA_ONLINE, SERVERB_ONLINE, SERVERC_ONLINE, INVALID };
+    enum ModelChange { SERVER_ONLINE, INVALID };
 
     struct ModelChangeEvent {
         double startTime; // when the event was created
         double time; // when the event will happen
         ModelChange change;
+        MTServerType::ServerType serverType; // type of the server the change applies to
+        int serverId; // id of the server the change applies to
+        bool ramp; // if true, the server ramps up its capacity when it becomes active
     };
 
     struct ModelChangeEventComp {
@@ -44,26 +50,44 @@ public:
           return lhs.time < rhs.time;
       }
     };
-    typedef std::multiset<ModelChangeEvent, ModelChangeEventComp> ModelChangeEvents;
+
+    /** expected changes sorted by time */
+    typedef std::vector<ModelChangeEvent> ModelChangeEvents;
     typedef std::map<std::string, MTServerType::ServerType> JobServeInfo;
 
 protected:
     static const char* HORIZON_PAR;
     virtual int numInitStages() const {return 2;}
     virtual void initialize(int stage);
-    virtual ModelChange getOnlineEventCode(MTServerType::ServerType serverType) const;
       struct ServerInfo {
+          std::string name;
           int activeServerCountLast;
           int maxServers;
+          int initialServers;
           double serviceTime;
           double serviceTimeVariance;
           double lowFidelityServiceTime;
           double lowFidelityServiceTimeVariance;
-
-          ServerInfo() : activeServerCountLast(0) {}
+          double bootDelay; // mean boot delay, negative to use the global one
+          double rampDuration; // time it takes an activated server to reach full capacity
+          double rampInitialCapacity; // fraction of its capacity a server has when activated
+          std::map<int, double> rampStarts; // activation time of each server still ramping up, by server id
+
+          ServerInfo() : activeServerCountLast(0), maxServers(0), initialServers(0), serviceTime(0),
+                  serviceTimeVariance(0), lowFidelityServiceTime(0),
+                  lowFidelityServiceTimeVariance(0), bootDelay(-1), rampDuration(0),
+                  rampInitialCapacity(1) {}
       };
 
-    ModelChangeEvents events;
+
+    /**
+     * Expected changes indexed by server type id. Each timeline is sorted
+     * by time, so the number of changes expected up to a given time is
+     * found with a binary search
+     */
+    std::vector<ModelChangeEvents> events;
+    std::vector<int> drainingServers; /**< servers being removed, indexed by server type id */
+    std::vector<int> suspendedServers; /**< servers suspended, indexed by server type id */
     JobServeInfo jobServeInfo;
 
 
@@ -81,20 +105,20 @@ protected:
     bool lowerDimmerMargin = false;
 
 
-    // these hold the current configuration, plus the events for the booting server
-    int activeServers; /**< number of active servers (there is one more powered up if a server is booting) */
     double brownoutFactor;
 
     Environment environment;
+    EnvironmentVector environmentForecast;
     Observations observations;
     int maxServers;
     double bootDelay;
     int horizon;
     int serverThreads;
     double serviceTime;
-    ServerInfo serverA;
-    ServerInfo serverB;
-    ServerInfo serverC;
+
+    /** server types indexed by type id, 0 (NONE) is not used */
+    std::vector<ServerInfo> serverInfo;
+    std::map<std::string, MTServerType::ServerType> serverTypeIds; /**< type id indexed by name */
     double serviceTimeVariance;
     double lowFidelityServiceTime;
     double lowFidelityServiceTimeVariance;
@@ -105,15 +129,27 @@ protected:
 =======
 >>>>>>> fc568acc6e702a7b574ac602ba7dad7a5b6cf2db
 
-    void addExpectedChange(double time, ModelChange change);
+    void addExpectedChange(double time, ModelChange change, MTServerType::ServerType serverType, int serverId, bool ramp = false);
+
+    /**
+     * @return the fraction of its capacity a server of the type activated
+     *   at activationTime has at time
+     */
+    double getRampCapacity(const ServerInfo& info, double activationTime, double time) const;
     const ServerInfo* getServerInfoObj(MTServerType::ServerType serverType) const;
 
     /**
-     * This method removes the last expected change (scheduled farthest in the future)
-     * For generality, addExpectedChange() should return some id that could be
-     * then used to remove the event.
+     * Removes the expected change of a server
+     *
+     * @return true if there was one
+     */
+    bool removeExpectedChange(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * Updates the booting servers of a type in the configuration from its
+     * expected changes
      */
-    void removeExpectedChange();
+    void updateBootingServers(MTServerType::ServerType serverType);
 
     bool isServerBooting() const;
     bool isServerBooting(MTServerType::ServerType serverType) const;
@@ -125,25 +161,101 @@ public:
     /* the following methods are less general */
 
     /**
-     * Returns the expected number of active servers at a time in the future
+     * Returns the expected capacity of the active servers at a time in the
+     * future, in servers. Servers that are ramping up after being activated
+     * (or that will be by then) count as the fraction of their capacity
+     * they will have at that time
      */
-    int getActiveServerCountIn(double deltaTime, MTServerType::ServerType serverType);
+    double getActiveServerCountIn(double deltaTime, MTServerType::ServerType serverType);
     int const getActiveServers() const;
+
+    /**
+     * Returns the number of active plus booting servers
+     */
     int const getServers() const;
 
-    void addServer(double bootDelay, MTServerType::ServerType serverType);
-    void serverBecameActive(MTServerType::ServerType serverType);
-    void removeServer(MTServerType::ServerType serverType);
+    /**
+     * Records that a server is being booted. Any number of servers can be
+     * booting at the same time
+     *
+     * @param serverId id of the server in its BootComplete
+     * @param ramp if true, the server ramps up its capacity when it becomes
+     *   active, as set with setRamp()
+     */
+    void addServer(double bootDelay, MTServerType::ServerType serverType, int serverId, bool ramp = false);
+    void serverBecameActive(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * Cancels the boot of a server that is not active yet
+     */
+    void cancelServerBoot(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * Records that an active server is being drained before its removal. It
+     * is still active until removeServer() is called for it
+     */
+    void serverDraining(MTServerType::ServerType serverType);
+    int getDrainingServers(MTServerType::ServerType serverType) const;
+    int getTotalDrainingServers() const;
+
+    /**
+     * Removes an active server (once it has been drained)
+     */
+    void removeServer(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * Records that an active server was drained and suspended. It is no
+     * longer active, but it can be resumed with resumeServer()
+     */
+    void serverSuspended(MTServerType::ServerType serverType, int serverId);
+
+    /**
+     * Records that a suspended server is being resumed. It is booting
+     * until serverBecameActive() is called for it
+     */
+    void resumeServer(double resumeDelay, MTServerType::ServerType serverType, int serverId);
+    int getSuspendedServers(MTServerType::ServerType serverType) const;
     double getAvgResponseTime() const;
 
     Configuration getConfiguration();
     const Environment& getEnvironment() const;
     virtual void setEnvironment(const Environment& environment);
+
+    /**
+     * Predicted environment for the next evaluation periods (the first
+     * element is for the next period), empty if there is no forecaster
+     */
+    const EnvironmentVector& getEnvironmentForecast() const;
+    virtual void setEnvironmentForecast(const EnvironmentVector& environmentForecast);
     const Observations& getObservations() const;
     void setObservations(const Observations& observations);
     int getMaxServers(MTServerType::ServerType serverType) const;
+
+    /**
+     * Number of server types declared in the serverTypes parameter. Their
+     * ids go from 1 to this number (inclusive)
+     */
+    unsigned getNumberOfServerTypes() const;
+    const std::string& getServerTypeName(MTServerType::ServerType serverType) const;
+
+    /**
+     * @return the id of the server type with the given name, NONE if there is none
+     */
+    MTServerType::ServerType getServerType(const std::string& name) const;
     double getEvaluationPeriod() const;
     double getBootDelay() const;
+
+    /**
+     * @return the mean boot delay of a server type
+     */
+    double getBootDelay(MTServerType::ServerType serverType) const;
+    void setBootDelay(double bootDelay, MTServerType::ServerType serverType);
+
+    /**
+     * Sets how the capacity of a server of a type ramps up after it
+     * becomes active, linearly from initialCapacity to 1 in duration seconds
+     */
+    void setRamp(double duration, double initialCapacity, MTServerType::ServerType serverType);
     int getHorizon() const;
 
     double getLowFidelityServiceTime(MTServerType::ServerType serverType) const;
@@ -158,8 +270,11 @@ public:
 
     void setDimmerFactor(double factor);
     double getDimmerFactor() const;
-    void setTrafficLoad(LoadBalancer::TrafficLoad serverA,
-              LoadBalancer::TrafficLoad serverB, LoadBalancer::TrafficLoad serverC);
+
+    /**
+     * @param traffic traffic load indexed by server type id
+     */
+    void setTrafficLoad(const std::vector<LoadBalancer::TrafficLoad>& traffic);
     void setJobServerInfo(std::string jobName, MTServerType::ServerType serverType);
     MTServerType::ServerType getJobServerInfo(std::string);
 
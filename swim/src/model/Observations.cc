@@ -15,5 +15,9 @@
 
 #include "Observations.h"
 
-Observations::Observations() : avgResponseTime(0.0), utilization(0.0) {}
+Observations::Observations() : avgResponseTime(0.0), utilization(0.0),
+        responseTimeP50(-1), responseTimeP95(-1), responseTimeP99(-1),
+        basicResponseTimeP95(-1), basicResponseTimeP99(-1),
+        optResponseTimeP95(-1), optResponseTimeP99(-1),
+        queueLength(-1), queueingDelay(-1) {}
 
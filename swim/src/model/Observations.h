@@ -16,6 +16,22 @@
 #ifndef OBSERVATIONS_H_
 #define OBSERVATIONS_H_
 
+#include <vector>
+#include <map>
+#include <string>
+
+/**
+ * Observations of a server, or of all the servers of a type
+ */
+struct ServerObservations {
+    unsigned servers = 0; /**< number of servers (for server types) */
+    double responseTime = 0;
+    double throughput = 0;
+    double utilization = 0; /**< for server types, average of its servers */
+    double queueLength = 0; /**< time-weighted mean; for server types, total of its servers */
+    double queueingDelay = 0;
+};
+
 class Observations {
 public:
     double basicResponseTime;
@@ -25,6 +41,21 @@ public:
     double avgResponseTime;
     double utilization;
 
+    /* response time percentiles (-1 if not available) */
+    double responseTimeP50;
+    double responseTimeP95;
+    double responseTimeP99;
+    double basicResponseTimeP95;
+    double basicResponseTimeP99;
+    double optResponseTimeP95;
+    double optResponseTimeP99;
+
+    double queueLength; /**< time-weighted mean of the total queue length */
+    double queueingDelay; /**< mean queueing delay of the requests */
+
+    std::vector<ServerObservations> serverTypes; /**< indexed by MTServerType::ServerType */
+    std::map<std::string, ServerObservations> servers; /**< indexed by server name */
+
     Observations();
 };
 
@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef __PLASA_IDISPATCHER_H_
+#define __PLASA_IDISPATCHER_H_
+
+/**
+ * Module that dispatches requests to the servers connected to its out
+ * gates, which are connected and disconnected while the simulation runs
+ * (e.g., LoadBalancer, SharedQueue)
+ */
+class IDispatcher
+{
+  public:
+    virtual ~IDispatcher() {}
+
+    /**
+     * Starts dispatching requests to the server connected to an out gate
+     */
+    virtual void addRoute(int gateIndex) = 0;
+
+    /**
+     * Stops dispatching requests to an out gate, so that it can be disconnected
+     */
+    virtual void removeRoute(int gateIndex) = 0;
+};
+
+#endif
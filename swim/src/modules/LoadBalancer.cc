@@ -55,11 +55,17 @@
 
 #include "LoadBalancer.h"
 #include <model/Model.h>
+#include <managers/execution/ExecutionManagerModBase.h>
 #include <MTServerType.h>
+#include <vector>
 #include <assert.h>
 
 Define_Module(LoadBalancer);
 
+namespace {
+    const int PROB_DIST_RNG = 4;
+}
+
 void LoadBalancer::initialize()
 {
     const char *algName = par("routingAlgorithm");
@@ -72,6 +78,56 @@ void LoadBalancer::initialize()
     }
 
     rrCounter = -1;
+    typeRoutesStale = true;
+    trafficStale = true;
+    if (routingAlgorithm == ALG_PROB_DIST) {
+        trafficDivertedSignal = registerSignal(ExecutionManagerModBase::SIG_TRAFFIC_DIVERTED);
+        getSimulation()->getSystemModule()->subscribe(trafficDivertedSignal, this);
+    }
+
+    // gates connected in the network definition are routed from the start
+    for (int i = 0; i < gateSize("out"); i++) {
+        if (gate("out", i)->isConnected()) {
+            addRoute(i);
+        }
+    }
+}
+
+void LoadBalancer::addRoute(int gateIndex) {
+    Enter_Method_Silent();
+    ASSERT(gateIndex >= 0 && gateIndex < gateSize("out"));
+    if (gateIndex >= (int) routePosition.size()) {
+        routePosition.resize(gateIndex + 1, -1);
+    }
+    ASSERT(routePosition[gateIndex] == -1);
+    routePosition[gateIndex] = routes.size();
+    routes.push_back(gateIndex);
+    typeRoutesStale = true;
+}
+
+void LoadBalancer::removeRoute(int gateIndex) {
+    Enter_Method_Silent();
+    ASSERT(gateIndex >= 0 && gateIndex < (int) routePosition.size() && routePosition[gateIndex] != -1);
+
+    // move the last route to the position of the removed one
+    int position = routePosition[gateIndex];
+    routes[position] = routes.back();
+    routePosition[routes[position]] = position;
+    routes.pop_back();
+    routePosition[gateIndex] = -1;
+    typeRoutesStale = true;
+}
+
+void LoadBalancer::receiveSignal(cComponent *source, simsignal_t signalID, bool value, cObject *details) {
+    if (signalID == trafficDivertedSignal) {
+        trafficStale = true;
+    }
+}
+
+void LoadBalancer::reroute(cMessage* msg) {
+    Enter_Method("reroute()");
+    take(msg);
+    handleMessage(msg);
 }
 
 void LoadBalancer::handleMessage(cMessage *msg)
@@ -81,11 +137,15 @@ void LoadBalancer::handleMessage(cMessage *msg)
     switch (routingAlgorithm)
     {
         case ALG_RANDOM:
-            outGateIndex = par("randomGateIndex");
+            if (!routes.empty()) {
+                outGateIndex = routes[intuniform(0, routes.size() - 1)];
+            }
             break;
         case ALG_ROUND_ROBIN:
-            rrCounter = (rrCounter + 1) % gateSize("out");
-            outGateIndex = rrCounter;
+            if (!routes.empty()) {
+                rrCounter = (rrCounter + 1) % routes.size();
+                outGateIndex = routes[rrCounter];
+            }
             break;
         case ALG_PROB_DIST:
             outGateIndex = getOutIndex();
@@ -103,52 +163,51 @@ void LoadBalancer::handleMessage(cMessage *msg)
 }
 
 int LoadBalancer::getOutIndex() {
-    bool debug = false;
-    int RNG = 4;
-
-    int outGateIndex = -1;
-    Model* model = check_and_cast<Model*> (getParentModule()->getSubmodule("model"));
-
-    float serverA = float(model->getConfiguration().getTraffic(MTServerType::ServerType::POWERFUL)*25)/100;
-    float serverB = float(model->getConfiguration().getTraffic(MTServerType::ServerType::AVERAGE)*25)/100;
-
-    double u = uniform(0, 1, RNG);
-
-    for (cModule::GateIterator i(this); !i.end(); i++) {
-        cGate* gate = i();
-
-        if (debug) {
-            std::cout << gate->getFullName() << ": ";
-            std::cout << "id = " << gate->getId() << ", ";
-            if (!gate->isVector()) {
-                std::cout << "scalar gate, ";
-            } else {
-                std::cout << "gate " << gate->getIndex() << " in vector "
-                        << gate->getName() << " of size "
-                        << gate->getVectorSize() << ", ";
-            }
-            std::cout << "type:" << cGate::getTypeName(gate->getType()) << "## " << gate->getIndex();
-            std::cout << "\n";
-        }
+    if (trafficStale) {
+        updateTrafficShares();
+    }
+    if (typeRoutesStale) {
+        updateTypeRoutes();
+    }
 
-        if (gate->getType() == cGate::OUTPUT) {
-            cGate* connectedGate = gate->getNextGate();
-            if (connectedGate != NULL) {
-                cModule* mod = connectedGate->getOwnerModule();
+    // the first type with u <= upper[type], skipping the types without traffic
+    double u = uniform(0, 1, PROB_DIST_RNG);
+    unsigned type = MTServerType::NONE + 1;
+    while (type + 1 < trafficUpper.size() && u > trafficUpper[type]) {
+        type++;
+    }
 
-                if (debug) std::cout << mod->getFullName() << "    u = " << u << endl;
+    if (type >= typeRoutes.size() || typeRoutes[type].empty()) {
+        return -1;
+    }
+    const std::vector<int>& candidates = typeRoutes[type];
+    return candidates[intuniform(0, candidates.size() - 1, PROB_DIST_RNG)];
+}
 
-                if ((strncmp(mod->getFullName(), "server_A_", 9) == 0 && u <= serverA)
-                        || ((strncmp(mod->getFullName(), "server_B_", 9) == 0 && u > serverA && u <= (serverA + serverB)))
-                        || (strncmp(mod->getFullName(), "server_C_", 9) == 0 && u > (serverA + serverB))) {
-                    outGateIndex = gate->getIndex();
-                    break;
-                }
-            }
+void LoadBalancer::updateTypeRoutes() {
+    ExecutionManagerModBase* pExecMgr = check_and_cast<ExecutionManagerModBase*> (getParentModule()->getSubmodule("executionManager"));
+    for (auto& routesOfType : typeRoutes) {
+        routesOfType.clear();
+    }
+    for (int gateIndex : routes) {
+        cModule* server = gate("out", gateIndex)->getNextGate()->getOwnerModule();
+        unsigned type = pExecMgr->getServerType(server);
+        if (type >= typeRoutes.size()) {
+            typeRoutes.resize(type + 1);
         }
+        typeRoutes[type].push_back(gateIndex);
     }
+    typeRoutesStale = false;
+}
 
-    if (debug) std::cout << outGateIndex << std::endl;
+void LoadBalancer::updateTrafficShares() {
+    Model* model = check_and_cast<Model*> (getParentModule()->getSubmodule("model"));
+    Configuration configuration = model->getConfiguration();
 
-    return outGateIndex;
+    trafficUpper.assign(configuration.getNumberOfServerTypes() + 1, 0.0);
+    for (unsigned type = MTServerType::NONE + 1; type < trafficUpper.size(); type++) {
+        trafficUpper[type] = trafficUpper[type - 1] + configuration.getTraffic(MTServerType::ServerType(type)) * 0.25;
+    }
+    trafficUpper.back() = 1.0; // the last type takes whatever is left
+    trafficStale = false;
 }
@@ -57,11 +57,13 @@
 #define __PLASASIM_LOADBALANCER_H_
 
 #include <omnetpp.h>
+#include <vector>
+#include "IDispatcher.h"
 
 /**
  * TODO - Generated class
  */
-class LoadBalancer : public omnetpp::cSimpleModule
+class LoadBalancer : public omnetpp::cSimpleModule, public omnetpp::cListener, public IDispatcher
 {
 
 public:
@@ -73,6 +75,28 @@ private:
     int routingAlgorithm;  // the algorithm we are using for routing
     int rrCounter;         // msgCounter for round robin routing
 
+    /*
+     * Servers come and go while the simulation runs, leaving unconnected
+     * gates in the out vector. The routing table holds the indices of
+     * the connected out gates, so that routing does not have to skip
+     * the holes, and it is updated incrementally with addRoute() and
+     * removeRoute()
+     */
+    std::vector<int> routes;        // indices of the connected out gates
+    std::vector<int> routePosition; // position in routes, indexed by gate index, -1 if not routed
+
+    /*
+     * Probabilistic routing picks a server type with the traffic shares
+     * of the configuration, and then one of the routes to servers of that
+     * type. Both are cached, and only recomputed when the routes change or
+     * the traffic is diverted
+     */
+    std::vector<std::vector<int>> typeRoutes; // routes indexed by server type id
+    bool typeRoutesStale;
+    std::vector<double> trafficUpper; // requests for type t are those with u in (upper[t - 1], upper[t]]
+    bool trafficStale;
+    omnetpp::simsignal_t trafficDivertedSignal;
+
     // routing algorithms
     enum {
         ALG_RANDOM,
@@ -87,6 +111,25 @@ protected:
     virtual void initialize();
     virtual void handleMessage(omnetpp::cMessage *msg);
     virtual int getOutIndex();
+    virtual void updateTypeRoutes();
+    virtual void updateTrafficShares();
+
+public:
+
+    virtual void addRoute(int gateIndex) override;
+    virtual void removeRoute(int gateIndex) override;
+    virtual void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, bool value, omnetpp::cObject *details) override;
+
+    /**
+     * @return the number of out gates requests are routed to
+     */
+    int getNumberOfRoutes() const { return routes.size(); }
+
+    /**
+     * Routes a request again, for example, one that was queued in a
+     * server that is being removed. There must be at least one route
+     */
+    void reroute(omnetpp::cMessage* msg);
 };
 
 #endif
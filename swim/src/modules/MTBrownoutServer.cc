@@ -41,6 +41,8 @@ Define_Module(MTBrownoutServer);
 
 std::map<std::string, long> MTBrownoutServer::requestCount;
 
+MTBrownoutServer::MTBrownoutServer() : rampDuration(0), rampInitialCapacity(1), rampStart(-1) {}
+
 void MTBrownoutServer::clearServerCache() {
     if (cacheClearsWhenReboot) {
         requestCount[this->getParentModule()->getName()] = 0;
@@ -56,6 +58,26 @@ void MTBrownoutServer::initialize() {
     cacheDeltaLow = par("cacheDeltaLow");
     cachePrecision = par("cachePrecision");
     cacheClearsWhenReboot = par("cacheClearsWhenReboot");
+    rampDuration = par("rampDuration");
+    rampInitialCapacity = par("rampInitialCapacity");
+    if (rampInitialCapacity <= 0 || rampInitialCapacity > 1) {
+        error("rampInitialCapacity must be in (0, 1]");
+    }
+}
+
+void MTBrownoutServer::startRamp() {
+    rampStart = simTime();
+}
+
+double MTBrownoutServer::getCapacity() const {
+    if (rampStart < 0 || rampDuration <= 0) {
+        return 1.0;
+    }
+    double elapsed = (simTime() - rampStart).dbl();
+    if (elapsed >= rampDuration) {
+        return 1.0;
+    }
+    return rampInitialCapacity + (1.0 - rampInitialCapacity) * elapsed / rampDuration;
 }
 
 simtime_t MTBrownoutServer::generateJobServiceTime(queueing::Job* pJob)  {
@@ -88,6 +110,9 @@ simtime_t MTBrownoutServer::generateJobServiceTime(queueing::Job* pJob)  {
     }
 #endif
 
+    // a server that is still ramping up serves more slowly
+    st = st / getCapacity();
+
     emit(registerSignal("serviceTime"), (pJob->getKind() == 1) ? -st.dbl() : st.dbl());
 
     return st;
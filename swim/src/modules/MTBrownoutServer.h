@@ -76,12 +76,33 @@ class MTBrownoutServer : public MTServer
      */
     bool cacheClearsWhenReboot;
 
+    /**
+     * After being activated, the server ramps up linearly from
+     * rampInitialCapacity to its full capacity in rampDuration seconds
+     * (e.g., JIT warm-up, filling connection pools), independently of the
+     * caching effect
+     */
+    double rampDuration;
+    double rampInitialCapacity;
+    simtime_t rampStart; /**< when the ramp started, negative if it has not */
+
   protected:
     virtual simtime_t generateJobServiceTime(queueing::Job* pJob);
     virtual void initialize() override;
 
   public:
+    MTBrownoutServer();
     void clearServerCache();
+
+    /**
+     * Starts ramping up the capacity of the server
+     */
+    void startRamp();
+
+    /**
+     * @return the fraction of its full capacity the server has now
+     */
+    double getCapacity() const;
 };
 
 #endif
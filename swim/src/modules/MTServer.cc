@@ -17,15 +17,19 @@
 #include "Job.h"
 #include "SelectionStrategies.h"
 #include "IPassiveQueue.h"
+#include "PassiveQueue.h"
+#include "WorkStealing.h"
+#include "SharedQueue.h"
 
 Define_Module(MTServer);
 
 using namespace queueing;
 
-MTServer::MTServer() : endExecutionMsg(NULL), selectionStrategy(NULL), maxThreads(0) {}
+MTServer::MTServer() : endExecutionMsg(NULL), selectionStrategy(NULL), maxThreads(0), batchPull(false), workStealing(NULL) {}
 
 void MTServer::initialize() {
     busySignal = registerSignal("busy");
+    responseTimeSignal = registerSignal("responseTime");
     emit(busySignal, false);
     maxThreads = par("threads");
     endExecutionMsg = new cMessage("end-execution");
@@ -33,6 +37,12 @@ void MTServer::initialize() {
     if (!selectionStrategy)
         error("invalid selection strategy");
     timeout = par("timeout");
+    batchPull = par("batchPull");
+
+    cModule* pWorkStealing = getModuleByPath(par("workStealingModule"));
+    if (pWorkStealing && check_and_cast<WorkStealing*>(pWorkStealing)->isEnabled()) {
+        workStealing = check_and_cast<WorkStealing*>(pWorkStealing);
+    }
 }
 
 MTServer::~MTServer() {
@@ -44,66 +54,155 @@ MTServer::~MTServer() {
 }
 
 void MTServer::handleMessage(cMessage* msg) {
+    bool wasBusy = beginUpdate();
+
     if (msg == endExecutionMsg)
     {
-        ASSERT(!runningJobs.empty());
-        updateJobTimes();
+        ASSERT(wasBusy);
 
         // send out all jobs that completed
         RunningJobs::iterator first = runningJobs.begin();
         while (first != runningJobs.end() && first->remainingServiceTime < 1e-10) {
-            send(first->pJob, "out");
-	    runningJobs.erase(first);
+            sendOut(first->pJob);
+            runningJobs.erase(first);
             first = runningJobs.begin();
         };
-
-        if (!runningJobs.empty()) {
-            scheduleNextCompletion();
-        } else {
-            emit(busySignal, false);
-            if (hasGUI()) getDisplayString().setTagArg("i",1,"");
-        }
     }
     else
     {
         if (!isIdle()){
             error("job arrived while already full");
-	}
+        }
+        startJob(check_and_cast<Job *>(msg));
+    }
+
+    refill();
+    endUpdate(wasBusy);
+}
+
+bool MTServer::beginUpdate() {
+    // these two are nops if there was no job running
+    updateJobTimes();
+    cancelEvent(endExecutionMsg);
+    return !runningJobs.empty();
+}
 
+void MTServer::endUpdate(bool wasBusy) {
+    if (!runningJobs.empty()) {
+        runningJobs.sort();
+        scheduleNextCompletion();
+    }
+
+    bool busy = !runningJobs.empty();
+    if (busy != wasBusy) {
+        emit(busySignal, busy);
+        if (hasGUI()) getDisplayString().setTagArg("i",1, busy ? "cyan" : "");
+    }
+}
+
+void MTServer::startJob(Job* pJob) {
+    if (timeout > 0 && pJob->getTotalQueueingTime() >= timeout) {
+        // don't serve this job, just send it out
+        sendOut(pJob);
+    } else {
         ScheduledJob job;
-        job.pJob = check_and_cast<Job *>(msg);
-        if (timeout > 0 && job.pJob->getTotalQueueingTime() >= timeout) {
-            // don't serve this job, just send it out
-            send(job.pJob, "out");
-        } else {
-            job.remainingServiceTime = generateJobServiceTime(job.pJob).dbl();
-            // these two are nops if there was no job running
-            updateJobTimes();
-            cancelEvent(endExecutionMsg);
-
-            runningJobs.push_back(job);
-            runningJobs.sort();
-            scheduleNextCompletion();
-
-            if (runningJobs.size() == 1) { // going from idle to busy
-                emit(busySignal, true);
-                if (hasGUI()) getDisplayString().setTagArg("i",1,"cyan");
+        job.pJob = pJob;
+        job.remainingServiceTime = generateJobServiceTime(pJob).dbl();
+        runningJobs.push_back(job);
+    }
+}
+
+void MTServer::refill() {
+
+    // examine all input queues, and request new jobs from a non empty queue
+    int k = -1;
+    while (isIdle() && (k = selectionStrategy->select()) >= 0)
+    {
+        cGate *gate = selectionStrategy->selectableGate(k);
+        IPassiveQueue *queue = check_and_cast<IPassiveQueue *>(gate->getOwnerModule());
+        if (batchPull) {
+            std::vector<Job *> jobs;
+            if (queue->requestBatch(gate->getIndex(), maxThreads - runningJobs.size(), jobs) > 0) {
+                EV << "pulled " << jobs.size() << " jobs from queue " << k << endl;
+                for (std::vector<Job *>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+                    take(*it);
+                    startJob(*it);
+                }
+
+                // jobs that timed out did not take a thread, so look again
+                continue;
             }
         }
+
+        EV << "requesting job from queue " << k << endl;
+        queue->request(gate->getIndex());
+        break;
     }
 
+    bool waiting = false;
+    if (isIdle() && k < 0)
+    {
+        // a shared queue only sends jobs through to servers that said they are idle
+        for (int i = 0; i < gateSize("in"); i++) {
+            cGate *queueGate = gate("in", i)->getPathStartGate();
+            SharedQueue *sharedQueue = dynamic_cast<SharedQueue *>(queueGate->getOwnerModule());
+            if (sharedQueue) {
+                sharedQueue->serverIdle(queueGate->getIndex());
+            }
+        }
 
-    if (runningJobs.size() < maxThreads) {
+        if (workStealing) {
+            Job* job;
+            while (isIdle() && (job = stealJob()) != nullptr) {
+                startJob(job);
+            }
 
-        // examine all input queues, and request a new job from a non empty queue
-        int k = selectionStrategy->select();
-        if (k >= 0)
-        {
-            EV << "requesting job from queue " << k << endl;
-            cGate *gate = selectionStrategy->selectableGate(k);
-            check_and_cast<IPassiveQueue *>(gate->getOwnerModule())->request(gate->getIndex());
+            // wait until some other queue has jobs
+            waiting = isIdle();
         }
     }
+
+    if (workStealing) {
+        workStealing->setWaiting(this, waiting);
+    }
+}
+
+bool MTServer::steal() {
+    Enter_Method("steal()");
+    if (!workStealing || !isIdle() || selectionStrategy->select() >= 0) {
+        return false;
+    }
+
+    Job* job = stealJob();
+    if (!job) {
+        return false;
+    }
+
+    // serve it as if it had arrived
+    bool wasBusy = beginUpdate();
+    startJob(job);
+    refill();
+    endUpdate(wasBusy);
+    return true;
+}
+
+Job* MTServer::stealJob() {
+
+    // servers being removed, or not added yet, must not take jobs
+    cModule* parent = getParentModule();
+    if (parent->hasGate("in") && !parent->gate("in")->isConnectedOutside()) {
+        return nullptr;
+    }
+
+    PassiveQueue* victim = workStealing->getLongestQueue();
+    if (!victim) {
+        return nullptr;
+    }
+    Job* job = victim->dequeue();
+    take(job);
+    workStealing->jobStolen(victim);
+    EV << "stole job from " << victim->getFullPath() << endl;
+    return job;
 }
 
 void MTServer::scheduleNextCompletion() {
@@ -122,6 +221,11 @@ void MTServer::updateJobTimes() {
     }
 }
 
+void MTServer::sendOut(Job* pJob) {
+    emit(responseTimeSignal, simTime() - pJob->getCreationTime());
+    send(pJob, "out");
+}
+
 void MTServer::finish() {
 }
 
@@ -140,3 +244,7 @@ bool MTServer::isIdle() {
 bool MTServer::isEmpty() {
     return runningJobs.size() == 0;
 }
+
+unsigned MTServer::getJobsInService() const {
+    return runningJobs.size();
+}
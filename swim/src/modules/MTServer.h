@@ -18,11 +18,13 @@
 
 #include <IServer.h>
 #include <list>
+#include <vector>
 
 namespace queueing {
     class Job;
     class SelectionStrategy;
 }
+class WorkStealing;
 
 class MTServer: public omnetpp::cSimpleModule, public queueing::IServer {
 protected:
@@ -38,16 +40,54 @@ protected:
     queueing::SelectionStrategy* selectionStrategy;
     unsigned maxThreads;
     simsignal_t busySignal;
+    simsignal_t responseTimeSignal;
 
     typedef std::list<ScheduledJob> RunningJobs;
     RunningJobs runningJobs;
     simtime_t timeout;
+    bool batchPull; // take as many jobs as there are free threads in one request
+    WorkStealing* workStealing; // nullptr if work stealing is disabled
 
     virtual void updateJobTimes();
     virtual void scheduleNextCompletion();
 
     virtual simtime_t generateJobServiceTime(queueing::Job* pJob);
 
+    /**
+     * Brings the remaining service times up to date and cancels the next
+     * completion, so that jobs can be added and removed. Every change to
+     * the running jobs must be done between beginUpdate() and endUpdate()
+     *
+     * @return true if the server was busy
+     */
+    bool beginUpdate();
+
+    /**
+     * Reschedules the next completion and signals changes in the busy state
+     */
+    void endUpdate(bool wasBusy);
+
+    /**
+     * Starts serving a job, or sends it out if it timed out while queueing
+     */
+    void startJob(queueing::Job* pJob);
+
+    /**
+     * Takes jobs for the free threads, from the input queues, or from
+     * other servers if work stealing is enabled
+     */
+    void refill();
+
+    /**
+     * @return a job stolen from the longest queue, or nullptr if there is none
+     */
+    queueing::Job* stealJob();
+
+    /**
+     * Sends a job out, tagging its response time with this server
+     */
+    virtual void sendOut(queueing::Job* pJob);
+
     virtual void initialize();
     virtual void handleMessage(cMessage *msg);
     virtual void finish();
@@ -62,6 +102,19 @@ public:
     virtual bool isIdle();
 
     virtual bool isEmpty();
+
+    /**
+     * @return the number of jobs being served
+     */
+    virtual unsigned getJobsInService() const;
+
+    /**
+     * Steals a job from the longest queue of another server, if this server
+     * has free threads, its queue is empty, and it is connected
+     *
+     * @return true if a job was stolen
+     */
+    virtual bool steal();
 };
 
 #endif /* MTSERVER_H_ */
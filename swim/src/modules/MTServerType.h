@@ -60,7 +60,13 @@
 
 class MTServerType : public MTBrownoutServer {
 public:
-    enum ServerType {
+    /**
+     * Server type id. Server types are declared in the ini file (see Model)
+     * and get consecutive ids starting at 1 in the order they are declared,
+     * so any positive value can be a valid type. A, B and C are the ids of
+     * the first three types.
+     */
+    enum ServerType : int {
         NONE,
         A,
         B,
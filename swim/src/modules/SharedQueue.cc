@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#include "SharedQueue.h"
+#include "Job.h"
+
+using namespace std;
+using namespace omnetpp;
+
+Define_Module(SharedQueue);
+
+void SharedQueue::initialize()
+{
+    droppedSignal = registerSignal("dropped");
+    queueingTimeSignal = registerSignal("queueingTime");
+    queueLengthSignal = registerSignal("queueLength");
+    emit(queueLengthSignal, 0);
+
+    capacity = par("capacity");
+    queue.setName("queue");
+}
+
+void SharedQueue::handleMessage(cMessage *msg)
+{
+    queueing::Job *job = check_and_cast<queueing::Job *>(msg);
+    job->setTimestamp();
+
+    if (!idleServers.empty()) {
+
+        // the queue is empty, so send it through to an idle server
+        int gateIndex = idleServers.back();
+        removeIdle(gateIndex);
+        send(job, "out", gateIndex);
+        return;
+    }
+
+    // check for container capacity
+    if (capacity >= 0 && queue.getLength() >= capacity) {
+        EV << "Queue full! Job dropped.\n";
+        emit(droppedSignal, 1);
+        delete msg;
+        return;
+    }
+
+    queue.insert(job);
+    emit(queueLengthSignal, length());
+    job->setQueueCount(job->getQueueCount() + 1);
+}
+
+int SharedQueue::length()
+{
+    return queue.getLength();
+}
+
+void SharedQueue::request(int gateIndex)
+{
+    Enter_Method("request()!");
+    removeIdle(gateIndex);
+    sendQueued(gateIndex);
+}
+
+int SharedQueue::requestBatch(int gateIndex, int maxJobs, std::vector<queueing::Job *>& jobs)
+{
+    Enter_Method("requestBatch()!");
+    removeIdle(gateIndex);
+
+    int taken = 0;
+    while (taken < maxJobs && !queue.isEmpty()) {
+        queueing::Job *job = (queueing::Job *) queue.pop();
+
+        simtime_t d = simTime() - job->getTimestamp();
+        job->setTotalQueueingTime(job->getTotalQueueingTime() + d);
+        emit(queueingTimeSignal, d);
+
+        drop(job);
+        jobs.push_back(job);
+        taken++;
+    }
+    if (taken > 0) {
+        emit(queueLengthSignal, length());
+    }
+    return taken;
+}
+
+void SharedQueue::sendQueued(int gateIndex)
+{
+    ASSERT(!queue.isEmpty());
+    queueing::Job *job = (queueing::Job *) queue.pop();
+    emit(queueLengthSignal, length());
+
+    simtime_t d = simTime() - job->getTimestamp();
+    job->setTotalQueueingTime(job->getTotalQueueingTime() + d);
+    emit(queueingTimeSignal, d);
+
+    send(job, "out", gateIndex);
+}
+
+void SharedQueue::serverIdle(int gateIndex)
+{
+    Enter_Method("serverIdle()");
+    if (gateIndex >= (int) routed.size() || !routed[gateIndex]) {
+        return;
+    }
+    if (!queue.isEmpty()) {
+        sendQueued(gateIndex);
+    } else if (idlePosition[gateIndex] == -1) {
+        idlePosition[gateIndex] = idleServers.size();
+        idleServers.push_back(gateIndex);
+    }
+}
+
+void SharedQueue::removeIdle(int gateIndex)
+{
+    if (gateIndex >= (int) idlePosition.size() || idlePosition[gateIndex] == -1) {
+        return;
+    }
+
+    // move the last idle server to the position of the removed one
+    int position = idlePosition[gateIndex];
+    idleServers[position] = idleServers.back();
+    idlePosition[idleServers[position]] = position;
+    idleServers.pop_back();
+    idlePosition[gateIndex] = -1;
+}
+
+void SharedQueue::addRoute(int gateIndex)
+{
+    Enter_Method_Silent();
+    ASSERT(gateIndex >= 0 && gateIndex < gateSize("out"));
+    if (gateIndex >= (int) routed.size()) {
+        routed.resize(gateIndex + 1, false);
+        idlePosition.resize(gateIndex + 1, -1);
+    }
+    routed[gateIndex] = true;
+
+    // a server that was just connected has all its threads free
+    serverIdle(gateIndex);
+}
+
+void SharedQueue::removeRoute(int gateIndex)
+{
+    Enter_Method_Silent();
+    ASSERT(gateIndex >= 0 && gateIndex < (int) routed.size() && routed[gateIndex]);
+    removeIdle(gateIndex);
+    routed[gateIndex] = false;
+}
@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef __PLASA_SHAREDQUEUE_H_
+#define __PLASA_SHAREDQUEUE_H_
+
+#include <omnetpp.h>
+#include <vector>
+#include "IPassiveQueue.h"
+#include "IDispatcher.h"
+
+/**
+ * Passive queue shared by all the servers (M/G/c style), instead of one
+ * queue per server
+ *
+ * Servers pull jobs with request() when they have free threads, as with
+ * PassiveQueue. A server that finds the queue empty reports it with
+ * serverIdle(), and is kept in a set of idle servers, from which an
+ * arriving job takes one in O(1).
+ */
+class SharedQueue : public omnetpp::cSimpleModule, public queueing::IPassiveQueue, public IDispatcher
+{
+    omnetpp::simsignal_t droppedSignal;
+    omnetpp::simsignal_t queueLengthSignal;
+    omnetpp::simsignal_t queueingTimeSignal;
+
+    int capacity;
+    omnetpp::cQueue queue;
+
+    std::vector<int> idleServers; // out gate indices of the idle servers
+    std::vector<int> idlePosition; // position in idleServers, indexed by gate index, -1 if not idle
+    std::vector<bool> routed; // true if the gate is connected to a server, indexed by gate index
+
+    void removeIdle(int gateIndex);
+
+    /**
+     * Sends the next queued job out a gate
+     */
+    void sendQueued(int gateIndex);
+
+  protected:
+    virtual void initialize();
+    virtual void handleMessage(omnetpp::cMessage *msg);
+
+  public:
+    virtual int length() override;
+    virtual void request(int gateIndex) override;
+    virtual int requestBatch(int gateIndex, int maxJobs, std::vector<queueing::Job *>& jobs) override;
+
+    /**
+     * Called by a server that has free threads and found the queue empty
+     */
+    void serverIdle(int gateIndex);
+
+    virtual void addRoute(int gateIndex) override;
+    virtual void removeRoute(int gateIndex) override;
+};
+
+#endif
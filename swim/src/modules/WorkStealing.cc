@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#include "WorkStealing.h"
+#include "MTServer.h"
+#include "PassiveQueue.h"
+
+using namespace std;
+using namespace omnetpp;
+
+Define_Module(WorkStealing);
+
+WorkStealing::WorkStealing() : enabled(false), wakeMsg(nullptr) {
+}
+
+WorkStealing::~WorkStealing() {
+    cancelAndDelete(wakeMsg);
+}
+
+void WorkStealing::initialize()
+{
+    enabled = par("enabled");
+    jobStolenSignal = registerSignal("jobStolen");
+    if (enabled) {
+        wakeMsg = new cMessage("wakeWaitingServers");
+        queueLengthSignal = registerSignal("queueLength");
+        getSimulation()->getSystemModule()->subscribe(queueLengthSignal, this);
+        getSimulation()->getSystemModule()->subscribe(PRE_MODEL_CHANGE, this);
+    }
+}
+
+void WorkStealing::handleMessage(cMessage *msg)
+{
+    ASSERT(msg == wakeMsg);
+
+    // let the waiting servers steal until they are busy or there is nothing left
+    while (!waitingServers.empty() && getLongestQueue() != nullptr) {
+        int serverId = *waitingServers.begin();
+        MTServer* server = check_and_cast<MTServer*>(getSimulation()->getModule(serverId));
+        if (!server->steal()) {
+            waitingServers.erase(serverId);
+        }
+    }
+}
+
+queueing::PassiveQueue* WorkStealing::getLongestQueue() const {
+    if (queueLengths.empty() || queueLengths.topValue() == 0) {
+        return nullptr;
+    }
+    return check_and_cast<queueing::PassiveQueue*>(getSimulation()->getModule(queueLengths.topKey()));
+}
+
+void WorkStealing::setWaiting(MTServer* server, bool waiting) {
+    if (waiting) {
+        waitingServers.insert(server->getId());
+    } else {
+        waitingServers.erase(server->getId());
+    }
+}
+
+void WorkStealing::jobStolen(queueing::PassiveQueue* victim) {
+    Enter_Method_Silent();
+    emit(jobStolenSignal, (long) victim->length());
+}
+
+void WorkStealing::receiveSignal(cComponent *source, simsignal_t signalID, long value, cObject *details) {
+    if (signalID != queueLengthSignal || dynamic_cast<queueing::PassiveQueue*>(source) == nullptr) {
+        return;
+    }
+    queueLengths.set(source->getId(), value);
+
+    /*
+     * the servers are not woken up here because the queue is still in the
+     * middle of handling the job
+     */
+    if (value > 0 && !waitingServers.empty() && !wakeMsg->isScheduled()) {
+        Enter_Method_Silent();
+        scheduleAt(simTime(), wakeMsg);
+    }
+}
+
+void WorkStealing::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) {
+    cPreModuleDeleteNotification* notification = dynamic_cast<cPreModuleDeleteNotification*>(obj);
+    if (notification) {
+        forget(notification->module);
+    }
+}
+
+void WorkStealing::forget(cModule* module) {
+    queueLengths.remove(module->getId());
+    waitingServers.erase(module->getId());
+    for (cModule::SubmoduleIterator it(module); !it.end(); it++) {
+        forget(*it);
+    }
+}
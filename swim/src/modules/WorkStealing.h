@@ -0,0 +1,80 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef __PLASA_WORKSTEALING_H_
+#define __PLASA_WORKSTEALING_H_
+
+#include <omnetpp.h>
+#include <set>
+#include <util/IndexedMaxHeap.h>
+
+namespace queueing {
+    class PassiveQueue;
+}
+class MTServer;
+
+/**
+ * Lets servers with free threads and an empty queue steal queued jobs
+ * from the longest queue of any other server
+ *
+ * The length of every queue is tracked with its queueLength signal in a
+ * max-heap, so that the longest queue is found without scanning them.
+ * Servers that could not steal wait here until some queue has jobs.
+ */
+class WorkStealing : public omnetpp::cSimpleModule, public omnetpp::cListener
+{
+    bool enabled;
+    omnetpp::simsignal_t queueLengthSignal;
+    omnetpp::simsignal_t jobStolenSignal;
+
+    IndexedMaxHeap queueLengths; // indexed by module id of the queue
+    std::set<int> waitingServers; // module ids of the servers waiting for jobs to steal
+    omnetpp::cMessage* wakeMsg;
+
+    /**
+     * Forgets a module, and its submodules, when it is deleted
+     */
+    void forget(omnetpp::cModule* module);
+
+  protected:
+    virtual void initialize();
+    virtual void handleMessage(omnetpp::cMessage *msg);
+
+  public:
+    WorkStealing();
+    virtual ~WorkStealing();
+
+    bool isEnabled() const { return enabled; }
+
+    /**
+     * @return the longest queue, or nullptr if all are empty
+     */
+    queueing::PassiveQueue* getLongestQueue() const;
+
+    /**
+     * Sets whether a server is waiting for jobs to steal
+     */
+    void setWaiting(MTServer* server, bool waiting);
+
+    /**
+     * Called by the server that stole a job, for statistics
+     */
+    void jobStolen(queueing::PassiveQueue* victim);
+
+    virtual void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, long value, omnetpp::cObject *details) override;
+    virtual void receiveSignal(omnetpp::cComponent *source, omnetpp::simsignal_t signalID, omnetpp::cObject *obj, omnetpp::cObject *details) override;
+};
+
+#endif
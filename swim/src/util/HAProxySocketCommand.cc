@@ -16,6 +16,7 @@
 #include "HAProxySocketCommand.h"
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 #include <sys/socket.h>
 #include <stdexcept>
 #include <unistd.h>
@@ -27,42 +28,174 @@
 
 using namespace std;
 
-HAProxySocketCommand::HAProxySocketCommand() {
+namespace {
+
+    // in interactive mode, HAProxy ends each reply with an empty line followed by this prompt
+    const string PROMPT = "\n> ";
+    const size_t READ_SIZE = 4096;
+}
+
+HAProxySocketCommand::HAProxySocketCommand() : socketFd(-1) {
     memset(&proxyAddress, 0, sizeof(proxyAddress));
 }
 
 void HAProxySocketCommand::setAddress(const std::string& socketPath) {
+    disconnect();
     proxyAddress.sun_family = AF_UNIX;
     snprintf(proxyAddress.sun_path, UNIX_PATH_MAX, "%s", socketPath.c_str());
 }
 
+void HAProxySocketCommand::connect() {
+    socketFd = socket(PF_UNIX, SOCK_STREAM, 0);
+    if (socketFd < 0) {
+        socketFd = -1;
+        throw runtime_error("HAProxySocketCommand::connect socket() failed");
+    }
+    if (::connect(socketFd, (struct sockaddr*) &proxyAddress, sizeof(proxyAddress)) != 0) {
+        disconnect();
+        throw runtime_error("HAProxySocketCommand::connect connect() failed");
+    }
+    buffer.clear();
 
-std::string HAProxySocketCommand::executeCommand(const std::string& cmd) {
-    int socket_fd = socket(PF_UNIX, SOCK_STREAM, 0);
-    if (socket_fd < 0) {
-        throw runtime_error("ExecutionManagerHAProxy::sendHAProxyCommand socket() failed");
+    // switch to interactive mode, so that HAProxy keeps the connection open
+    static const string PROMPT_COMMAND = "prompt\n";
+    if (send(socketFd, PROMPT_COMMAND.data(), PROMPT_COMMAND.length(), MSG_NOSIGNAL) < (ssize_t) PROMPT_COMMAND.length()) {
+        disconnect();
+        throw runtime_error("HAProxySocketCommand::connect send() failed");
+    }
+
+    // the first prompt may come without the empty line before it
+    buffer.insert(0, 1, '\n');
+    string reply;
+    if (!readReply(reply)) {
+        disconnect();
+        throw runtime_error("HAProxySocketCommand::connect HAProxy closed the connection");
+    }
+}
+
+void HAProxySocketCommand::disconnect() {
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+    buffer.clear();
+}
+
+bool HAProxySocketCommand::readReply(std::string& reply) {
+    size_t searchFrom = 0;
+    size_t end;
+    while ((end = buffer.find(PROMPT, searchFrom)) == string::npos) {
+
+        // the prompt may have been split between reads
+        searchFrom = (buffer.length() >= PROMPT.length()) ? buffer.length() - PROMPT.length() + 1 : 0;
+
+        size_t length = buffer.length();
+        buffer.resize(length + READ_SIZE);
+        ssize_t n;
+        do {
+            n = read(socketFd, &buffer[length], READ_SIZE);
+        } while (n < 0 && errno == EINTR);
+        buffer.resize(length + ((n > 0) ? n : 0));
+        if (n == 0 || (n < 0 && errno == ECONNRESET)) {
+            return false;
+        }
+        if (n < 0) {
+            throw runtime_error("HAProxySocketCommand::readReply read() failed");
+        }
+    }
+
+    // keep the line break that ends the reply, as replies had without prompt mode
+    reply.assign(buffer, 0, end + 1);
+    buffer.erase(0, end + PROMPT.length());
+    return true;
+}
+
+bool HAProxySocketCommand::sendCommands(const std::vector<std::string>& cmds, std::vector<std::string>& replies) {
+    string request;
+    for (const string& cmd : cmds) {
+        request += cmd;
+        request += '\n';
     }
-    if (connect(socket_fd, (struct sockaddr*) &proxyAddress, sizeof(proxyAddress)) != 0) {
-        close(socket_fd);
-        throw runtime_error("ExecutionManagerHAProxy::sendHAProxyCommand connect() failed");
+
+    size_t sent = 0;
+    while (sent < request.length()) {
+        ssize_t n = send(socketFd, request.data() + sent, request.length() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            if (errno == EPIPE || errno == ECONNRESET) {
+                return false;
+            }
+            throw runtime_error("HAProxySocketCommand::sendCommands send() failed");
+        }
+        sent += n;
     }
-    ssize_t n = write(socket_fd, cmd.c_str(), cmd.length());
-    if (n < (ssize_t) cmd.length()) {
-        close(socket_fd);
-        throw runtime_error("ExecutionManagerHAProxy::sendHAProxyCommand write() failed");
+
+    replies.clear();
+    replies.reserve(cmds.size());
+    string reply;
+    while (replies.size() < cmds.size()) {
+        if (!readReply(reply)) {
+            if (replies.empty()) {
+                return false;
+            }
+            throw runtime_error("HAProxySocketCommand::sendCommands HAProxy closed the connection");
+        }
+        replies.push_back(reply);
     }
-    char buffer[4096 + 1];
-    n = read(socket_fd, buffer, 4096);
-    if (n == -1) {
-        close(socket_fd);
-        throw runtime_error("ExecutionManagerHAProxy::sendHAProxyCommand read() failed");
+    return true;
+}
+
+std::vector<std::string> HAProxySocketCommand::executeCommands(const std::vector<std::string>& cmds) {
+    vector<string> replies;
+    if (cmds.empty()) {
+        return replies;
+    }
+
+    bool connected = (socketFd >= 0);
+    if (!connected) {
+        connect();
+    }
+    if (!sendCommands(cmds, replies)) {
+
+        // HAProxy closed an idle connection, so none of the commands was executed
+        disconnect();
+        if (!connected) {
+            throw runtime_error("HAProxySocketCommand::executeCommands HAProxy closed the connection");
+        }
+        connect();
+        if (!sendCommands(cmds, replies)) {
+            disconnect();
+            throw runtime_error("HAProxySocketCommand::executeCommands HAProxy closed the connection");
+        }
+    }
+    return replies;
+}
+
+std::string HAProxySocketCommand::executeCommand(const std::string& cmd) {
+    commandLines.clear();
+    size_t start = 0;
+    while (start < cmd.length()) {
+        size_t end = cmd.find('\n', start);
+        if (end == string::npos) {
+            end = cmd.length();
+        }
+        if (end > start) {
+            commandLines.push_back(cmd.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+
+    string reply;
+    for (const string& commandReply : executeCommands(commandLines)) {
+        reply += commandReply;
     }
-    buffer[n] = 0;
-    return string(buffer);
+    return reply;
 }
 
 
 HAProxySocketCommand::~HAProxySocketCommand() {
-    // TODO Auto-generated destructor stub
+    disconnect();
 }
 
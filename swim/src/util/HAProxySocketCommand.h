@@ -18,18 +18,62 @@
 
 #include <sys/un.h>
 #include <string>
+#include <vector>
 
+/**
+ * Client for the HAProxy admin socket
+ *
+ * The connection is kept open in interactive (prompt) mode, in which
+ * HAProxy ends each reply with a prompt, so that any number of commands
+ * can be sent in one write and their replies, of any length, read back
+ * one by one. If HAProxy closes the connection (e.g., after its stats
+ * timeout), it is opened again the next time commands are sent
+ */
 class HAProxySocketCommand {
     struct sockaddr_un proxyAddress;
+    int socketFd; // -1 if not connected
+    std::string buffer; // data received and not consumed yet, reused across commands
+    std::vector<std::string> commandLines;
+
+    void connect();
+
+    /**
+     * Reads until the buffer holds a whole reply
+     *
+     * @return the reply, without the prompt, or false if the connection
+     *   was closed before that
+     */
+    bool readReply(std::string& reply);
+
+    /**
+     * Sends all the commands in one write, and reads their replies
+     *
+     * @return false if the connection was closed before any reply was read
+     */
+    bool sendCommands(const std::vector<std::string>& cmds, std::vector<std::string>& replies);
+
 public:
     HAProxySocketCommand();
+    HAProxySocketCommand(const HAProxySocketCommand&) = delete;
+    HAProxySocketCommand& operator=(const HAProxySocketCommand&) = delete;
     void setAddress(const std::string& socketPath);
 
     /**
-     * sends command(s) to HAProxy admin socket and returns reply
+     * sends command(s), one per line, to HAProxy admin socket and returns
+     * their replies concatenated
      */
     std::string executeCommand(const std::string& cmd);
 
+    /**
+     * Sends several commands in one round trip
+     *
+     * @param cmds commands, without the line terminator
+     * @return the reply to each command
+     */
+    std::vector<std::string> executeCommands(const std::vector<std::string>& cmds);
+
+    void disconnect();
+
     virtual ~HAProxySocketCommand();
 };
 
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#include "IndexedMaxHeap.h"
+#include <utility>
+
+void IndexedMaxHeap::set(int key, long value) {
+    auto it = positions.find(key);
+    if (it == positions.end()) {
+        positions[key] = heap.size();
+        heap.push_back(Node{key, value});
+        siftUp(heap.size() - 1);
+    } else {
+        unsigned position = it->second;
+        long oldValue = heap[position].value;
+        heap[position].value = value;
+        if (value > oldValue) {
+            siftUp(position);
+        } else {
+            siftDown(position);
+        }
+    }
+}
+
+void IndexedMaxHeap::remove(int key) {
+    auto it = positions.find(key);
+    if (it == positions.end()) {
+        return;
+    }
+
+    // move the last node to the position of the removed one, and restore the heap
+    unsigned position = it->second;
+    positions.erase(it);
+    unsigned last = heap.size() - 1;
+    if (position != last) {
+        heap[position] = heap[last];
+        positions[heap[position].key] = position;
+    }
+    heap.pop_back();
+    if (position < heap.size()) {
+        siftUp(position);
+        siftDown(position);
+    }
+}
+
+void IndexedMaxHeap::swapNodes(unsigned a, unsigned b) {
+    std::swap(heap[a], heap[b]);
+    positions[heap[a].key] = a;
+    positions[heap[b].key] = b;
+}
+
+void IndexedMaxHeap::siftUp(unsigned position) {
+    while (position > 0) {
+        unsigned parent = (position - 1) / 2;
+        if (heap[parent].value >= heap[position].value) {
+            break;
+        }
+        swapNodes(parent, position);
+        position = parent;
+    }
+}
+
+void IndexedMaxHeap::siftDown(unsigned position) {
+    while (true) {
+        unsigned largest = position;
+        unsigned left = 2 * position + 1;
+        unsigned right = left + 1;
+        if (left < heap.size() && heap[left].value > heap[largest].value) {
+            largest = left;
+        }
+        if (right < heap.size() && heap[right].value > heap[largest].value) {
+            largest = right;
+        }
+        if (largest == position) {
+            break;
+        }
+        swapNodes(largest, position);
+        position = largest;
+    }
+}
@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef INDEXEDMAXHEAP_H_
+#define INDEXEDMAXHEAP_H_
+
+#include <vector>
+#include <unordered_map>
+
+/**
+ * Binary max-heap of values identified by a key, which keeps the position
+ * of each key in the heap so that the value of any key can be updated or
+ * removed in O(log n), and the key with the largest value found in O(1)
+ */
+class IndexedMaxHeap {
+    struct Node {
+        int key;
+        long value;
+    };
+
+    std::vector<Node> heap;
+    std::unordered_map<int, unsigned> positions; // position in the heap of each key
+
+    void siftUp(unsigned position);
+    void siftDown(unsigned position);
+    void swapNodes(unsigned a, unsigned b);
+
+public:
+
+    /**
+     * Sets the value of a key, adding the key if it is not in the heap
+     */
+    void set(int key, long value);
+
+    /**
+     * Removes a key, if it is in the heap
+     */
+    void remove(int key);
+
+    bool contains(int key) const { return positions.count(key) > 0; }
+    bool empty() const { return heap.empty(); }
+
+    /**
+     * @return key with the largest value. The heap must not be empty
+     */
+    int topKey() const { return heap.front().key; }
+
+    /**
+     * @return the largest value. The heap must not be empty
+     */
+    long topValue() const { return heap.front().value; }
+};
+
+#endif /* INDEXEDMAXHEAP_H_ */
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef SNAPSHOTBUFFER_H_
+#define SNAPSHOTBUFFER_H_
+
+#include <atomic>
+
+/**
+ * Lock-free buffer through which one writer thread publishes snapshots
+ * to one reader thread
+ *
+ * The writer fills the back slot and publishes it by swapping it with
+ * the middle slot, and the reader takes the middle slot, if it is newer
+ * than its own, by swapping it with the front slot. With three slots
+ * neither of them ever waits for the other, nor sees a snapshot that is
+ * being written. Slots are reused, so a snapshot that keeps its capacity
+ * (e.g., vectors) does not allocate once the buffer is warmed up
+ */
+template <class T>
+class SnapshotBuffer {
+    static const unsigned INDEX_MASK = 3;
+    static const unsigned FRESH = 4; // the middle slot has a snapshot the reader has not taken
+
+    T slots[3];
+    std::atomic<unsigned> middle;
+    unsigned back; // only used by the writer
+    unsigned front; // only used by the reader
+
+public:
+    SnapshotBuffer() : middle(1), back(0), front(2) {}
+
+    /**
+     * @return the slot the writer fills, which holds an older snapshot
+     */
+    T& getBack() { return slots[back]; }
+
+    /**
+     * Makes the back slot the latest snapshot
+     */
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * @return the latest snapshot published. It stays valid until the
+     *   next call
+     */
+    const T& read() {
+        if (middle.load(std::memory_order_relaxed) & FRESH) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return slots[front];
+    }
+};
+
+#endif /* SNAPSHOTBUFFER_H_ */
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#include "TimeWindowHistogram.h"
+#include <cmath>
+#include <climits>
+
+using namespace std;
+
+const unsigned TimeWindowHistogram::DEFAULT_SUB_WINDOWS;
+const unsigned TimeWindowHistogram::BINS;
+
+TimeWindowHistogram::TimeWindowHistogram() : aggregate(BINS, 0) {
+    setWindow(60);
+}
+
+TimeWindowHistogram::~TimeWindowHistogram() {
+}
+
+void TimeWindowHistogram::reset() {
+    for (auto& subWindow : subWindows) {
+        subWindow.index = LONG_MIN;
+        subWindow.count = 0;
+        subWindow.bins.assign(BINS, 0);
+    }
+    aggregate.assign(BINS, 0);
+    count = 0;
+    currentIndex = LONG_MIN;
+}
+
+void TimeWindowHistogram::setWindow(unsigned seconds, unsigned numberOfSubWindows) {
+    if (numberOfSubWindows == 0) {
+        numberOfSubWindows = 1;
+    }
+    subWindows.resize(numberOfSubWindows);
+    subWindowWidth = (double) seconds / numberOfSubWindows;
+    reset();
+}
+
+void TimeWindowHistogram::record(double value) {
+    long current = removeOldSubWindows();
+    SubWindow& subWindow = subWindows[current % subWindows.size()];
+    subWindow.index = current; // if the slot was reused, it was already cleared
+    unsigned bin = getBin(value);
+    subWindow.bins[bin]++;
+    subWindow.count++;
+    aggregate[bin]++;
+    count++;
+}
+
+unsigned TimeWindowHistogram::getCount() {
+    removeOldSubWindows();
+    return count;
+}
+
+double TimeWindowHistogram::getPercentile(double percentile) {
+    return getPercentile(percentile, { this });
+}
+
+double TimeWindowHistogram::getPercentile(double percentile,
+        const std::vector<TimeWindowHistogram*>& histograms) {
+    unsigned total = 0;
+    for (auto histogram : histograms) {
+        total += histogram->getCount();
+    }
+    if (total == 0) {
+        return -1;
+    }
+
+    // rank of the percentile (nearest-rank method)
+    unsigned rank = (unsigned) ceil(percentile / 100.0 * total);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    unsigned cumulative = 0;
+    for (unsigned bin = 0; bin < BINS; bin++) {
+        for (auto histogram : histograms) {
+            cumulative += histogram->aggregate[bin];
+        }
+        if (cumulative >= rank) {
+            return getBinValue(bin);
+        }
+    }
+    return getBinValue(BINS - 1);
+}
+
+long TimeWindowHistogram::removeOldSubWindows() {
+    long current = (long) floor(omnetpp::simTime().dbl() / subWindowWidth);
+    if (current == currentIndex) {
+        return current;
+    }
+    currentIndex = current;
+
+    long oldest = current - (long) subWindows.size() + 1;
+    for (auto& subWindow : subWindows) {
+        if (subWindow.count > 0 && subWindow.index < oldest) {
+            for (unsigned bin = 0; bin < BINS; bin++) {
+                aggregate[bin] -= subWindow.bins[bin];
+            }
+            count -= subWindow.count;
+            subWindow.bins.assign(BINS, 0);
+            subWindow.count = 0;
+        }
+    }
+    return current;
+}
+
+unsigned TimeWindowHistogram::getBin(double value) {
+    if (!(value > 0)) {
+        return 0;
+    }
+
+    // value = mantissa * 2^exponent, with mantissa in [0.5, 1)
+    int exponent;
+    double mantissa = frexp(value, &exponent);
+    exponent--; // so that value = (2 * mantissa) * 2^exponent, with 2 * mantissa in [1, 2)
+    if (exponent < MIN_EXPONENT) {
+        return 0;
+    }
+    if (exponent >= MAX_EXPONENT) {
+        return BINS - 1;
+    }
+    unsigned subBin = (unsigned) ((2 * mantissa - 1) * SUB_BINS);
+    return (exponent - MIN_EXPONENT) * SUB_BINS + subBin;
+}
+
+double TimeWindowHistogram::getBinValue(unsigned bin) {
+    int exponent = MIN_EXPONENT + bin / SUB_BINS;
+    double subBin = bin % SUB_BINS;
+    return ldexp(1 + (subBin + 0.5) / SUB_BINS, exponent);
+}
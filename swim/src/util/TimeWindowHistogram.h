@@ -0,0 +1,109 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef TIMEWINDOWHISTOGRAM_H_
+#define TIMEWINDOWHISTOGRAM_H_
+
+#include <vector>
+#include <omnetpp.h>
+
+/**
+ * Histogram of the values recorded in a sliding time window, used to
+ * compute percentiles (e.g., of response time)
+ *
+ * Values are counted in log-scaled bins (in the style of HDR histograms):
+ * each power of 2 is split in SUB_BINS linear bins, so the relative error
+ * of a percentile is bounded by 1/SUB_BINS regardless of its magnitude.
+ * The window is divided in sub-windows, each with its own histogram, and
+ * an aggregate histogram of the whole window is kept up to date. Recording
+ * is O(1); a sub-window that falls out of the window is subtracted from the
+ * aggregate once, and a percentile query walks the aggregate bins.
+ * Memory is bounded by (sub-windows + 1) * bins, independently of the rate.
+ *
+ * The window slides one sub-window at a time, so the histogram covers
+ * between (subWindows - 1) / subWindows of the window and the full window.
+ *
+ * Histograms with the same window and number of sub-windows can be merged
+ * to compute percentiles over their union (see getPercentile(...)).
+ */
+class TimeWindowHistogram {
+public:
+    TimeWindowHistogram();
+    virtual ~TimeWindowHistogram();
+
+    virtual void reset();
+
+    /**
+     * Sets the window, which resets the histogram
+     *
+     * @param seconds window duration
+     * @param subWindows number of sub-windows the window slides by
+     */
+    virtual void setWindow(unsigned seconds, unsigned subWindows = DEFAULT_SUB_WINDOWS);
+    virtual void record(double value);
+    virtual unsigned getCount();
+
+    /**
+     * Returns the given percentile of the values in the window
+     *
+     * @param percentile in (0, 100]
+     * @return the percentile, or -1 if the window is empty
+     */
+    virtual double getPercentile(double percentile);
+
+    /**
+     * Returns the given percentile of the union of the values in the
+     * windows of several histograms, which must have the same window and
+     * number of sub-windows
+     */
+    static double getPercentile(double percentile, const std::vector<TimeWindowHistogram*>& histograms);
+
+    static const unsigned DEFAULT_SUB_WINDOWS = 12;
+
+protected:
+    static const unsigned SUB_BINS = 64; /**< bins per power of 2 */
+    static const int MIN_EXPONENT = -12; /**< values < 2^-12 (~0.24ms) go in the first bin */
+    static const int MAX_EXPONENT = 12;  /**< values >= 2^12 (~68min) go in the last bin */
+    static const unsigned BINS = (MAX_EXPONENT - MIN_EXPONENT) * SUB_BINS;
+
+    struct SubWindow {
+        long index; /**< absolute sub-window number (start / width) */
+        unsigned count;
+        std::vector<unsigned> bins;
+    };
+
+    std::vector<SubWindow> subWindows; /**< ring indexed by absolute index modulo size */
+    std::vector<unsigned> aggregate; /**< sum of the live sub-windows */
+    unsigned count = 0; /**< number of values in the aggregate */
+    double subWindowWidth = 0; /**< in seconds */
+    long currentIndex; /**< sub-window index when old ones were last removed */
+
+    static unsigned getBin(double value);
+
+    /**
+     * Returns a representative value of the bin (its midpoint)
+     */
+    static double getBinValue(unsigned bin);
+
+    /**
+     * Subtracts from the aggregate the sub-windows that fell out of the
+     * window
+     *
+     * @return the current absolute sub-window index
+     */
+    long removeOldSubWindows();
+};
+
+#endif /* TIMEWINDOWHISTOGRAM_H_ */
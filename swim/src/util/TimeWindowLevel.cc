@@ -0,0 +1,98 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#include "TimeWindowLevel.h"
+#include <cmath>
+
+using namespace omnetpp;
+
+const unsigned TimeWindowLevel::DEFAULT_CHECKPOINTS;
+
+TimeWindowLevel::TimeWindowLevel() {
+    setWindow(60);
+}
+
+TimeWindowLevel::~TimeWindowLevel() {
+}
+
+void TimeWindowLevel::setWindow(unsigned seconds, unsigned numberOfCheckpoints) {
+    if (numberOfCheckpoints == 0) {
+        numberOfCheckpoints = 1;
+    }
+    checkpointPeriod = (double) seconds / numberOfCheckpoints;
+
+    /*
+     * one more slot than checkpoints in the window, so that the oldest one
+     * is kept until a newer one is at least (checkpoints - 1) periods old
+     */
+    checkpoints.assign(numberOfCheckpoints + 1, Checkpoint());
+
+    level = 0;
+    integral = 0;
+    lastChange = simTime();
+    checkpoints[0] = Checkpoint { lastChange, 0 };
+    head = 0;
+    count = 1;
+    nextCheckpoint = checkpointPeriod * (std::floor(lastChange.dbl() / checkpointPeriod.dbl()) + 1);
+}
+
+void TimeWindowLevel::setLevel(double newLevel) {
+    updateCheckpoints();
+    simtime_t now = simTime();
+    integral = getIntegral(now);
+    lastChange = now;
+    level = newLevel;
+}
+
+double TimeWindowLevel::getAverage() {
+    updateCheckpoints();
+    simtime_t now = simTime();
+    const Checkpoint& oldest = checkpoints[head];
+    double span = (now - oldest.time).dbl();
+    if (span <= 0) {
+        return level;
+    }
+    return (getIntegral(now) - oldest.integral) / span;
+}
+
+void TimeWindowLevel::updateCheckpoints() {
+    simtime_t now = simTime();
+    if (now < nextCheckpoint) {
+        return;
+    }
+
+    // after a long gap only the last checkpoints can still be in the window
+    simtime_t skipTo = now - checkpointPeriod * (checkpoints.size() - 1);
+    if (nextCheckpoint < skipTo) {
+        nextCheckpoint = checkpointPeriod * std::floor(skipTo.dbl() / checkpointPeriod.dbl());
+    }
+
+    while (nextCheckpoint <= now) {
+        if (count == checkpoints.size()) {
+            head = (head + 1) % checkpoints.size();
+            count--;
+        }
+        checkpoints[(head + count) % checkpoints.size()] = Checkpoint { nextCheckpoint, getIntegral(nextCheckpoint) };
+        count++;
+        nextCheckpoint += checkpointPeriod;
+    }
+
+    // drop the checkpoints that are older than the window
+    simtime_t windowStart = now - checkpointPeriod * (checkpoints.size() - 1);
+    while (count > 1 && checkpoints[head].time < windowStart) {
+        head = (head + 1) % checkpoints.size();
+        count--;
+    }
+}
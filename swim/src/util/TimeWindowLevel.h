@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *  
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *  
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+#ifndef TIMEWINDOWLEVEL_H_
+#define TIMEWINDOWLEVEL_H_
+
+#include <vector>
+#include <omnetpp.h>
+
+/**
+ * Time average of a piecewise constant signal (e.g., busy/idle for
+ * utilization) in a sliding time window
+ *
+ * Instead of keeping every change of the signal, it keeps a running
+ * integral of the signal over time, and a small ring of checkpoints of
+ * the integral taken every window / checkpoints seconds. The average over
+ * the window is the difference between the integral now and at the oldest
+ * checkpoint in the window, divided by the time between them, so setting
+ * the level and getting the average are O(1) (amortized) with no storage
+ * per change.
+ *
+ * As with the bucketed TimeWindowStats, the window slides one checkpoint
+ * period at a time, so the average covers between
+ * (checkpoints - 1) / checkpoints of the window and the full window.
+ */
+class TimeWindowLevel {
+public:
+    TimeWindowLevel();
+    virtual ~TimeWindowLevel();
+
+    /**
+     * Sets the window, and starts measuring from now with level 0
+     *
+     * @param seconds window duration
+     * @param checkpoints number of checkpoints in the window
+     */
+    virtual void setWindow(unsigned seconds, unsigned checkpoints = DEFAULT_CHECKPOINTS);
+
+    /**
+     * Sets the level of the signal from now on
+     */
+    virtual void setLevel(double level);
+
+    inline void busy() { setLevel(1); }
+    inline void idle() { setLevel(0); }
+
+    /**
+     * Returns the time average of the level in the window, which for a
+     * busy/idle signal is the utilization (in [0,1])
+     */
+    virtual double getAverage();
+
+    static const unsigned DEFAULT_CHECKPOINTS = 12;
+
+protected:
+    struct Checkpoint {
+        omnetpp::simtime_t time;
+        double integral; /**< integral of the level up to time */
+    };
+
+    double level = 0;
+    double integral = 0; /**< integral of the level up to lastChange */
+    omnetpp::simtime_t lastChange;
+
+    /**
+     * Ring of checkpoints, oldest first starting at head. The first one
+     * is the start of the measurement, the rest are at multiples of
+     * checkpointPeriod
+     */
+    std::vector<Checkpoint> checkpoints;
+    size_t head = 0;
+    size_t count = 0;
+    omnetpp::simtime_t checkpointPeriod;
+    omnetpp::simtime_t nextCheckpoint;
+
+    inline double getIntegral(omnetpp::simtime_t time) const {
+        return integral + level * (time - lastChange).dbl();
+    }
+
+    /**
+     * Takes the checkpoints that are due, and drops the ones that fell
+     * out of the window
+     */
+    void updateCheckpoints();
+};
+
+#endif /* TIMEWINDOWLEVEL_H_ */
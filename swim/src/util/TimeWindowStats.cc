@@ -15,6 +15,7 @@
 
 #include "TimeWindowStats.h"
 #include <iostream>
+#include <climits>
 
 using namespace std;
 
@@ -27,8 +28,14 @@ TimeWindowStats::~TimeWindowStats() {
 }
 
 void TimeWindowStats::reset() {
-    entries.clear();
-    pStats.reset(nullptr);
+    head = 0;
+    count = 0;
+    mean = 0;
+    m2 = 0;
+    for (auto& bucket : buckets) {
+        bucket = Bucket { LONG_MIN, 0, 0, 0, 0 };
+    }
+    lastValueTime = getTimestampNow();
 }
 
 void TimeWindowStats::setWindow(unsigned seconds) {
@@ -37,71 +44,195 @@ void TimeWindowStats::setWindow(unsigned seconds) {
 #else
     window = std::chrono::seconds(seconds);
 #endif
+    if (!buckets.empty()) {
+        setBuckets(buckets.size());
+    }
+}
+
+void TimeWindowStats::setBuckets(unsigned numberOfBuckets) {
+    buckets.assign(numberOfBuckets, Bucket());
+    bucketWidth = (numberOfBuckets > 0) ? asDouble(window) / numberOfBuckets : 0;
+    std::vector<Entry>().swap(entries); // not used in bucketed mode
+    reset();
 }
 
 
 void TimeWindowStats::record(double value) {
-    if (entries.size() > ENTRIES_BETWEEN_CHECKS) {
+    if (!buckets.empty()) {
+        auto now = getTimestampNow();
+        accrueAboveZeroTime(now);
+        Bucket& bucket = getBucket(getBucketIndex(now));
+        bucket.count++;
+        double delta = value - bucket.mean;
+        bucket.mean += delta / bucket.count;
+        bucket.m2 += delta * (value - bucket.mean);
+    } else {
         removeOldEntries();
+        pushEntry(Entry { getTimestampNow(), value });
     }
-    pStats.reset(nullptr);
-    entries.push_back(Entry { getTimestampNow(), value });
     lastValue = value;
 }
 
 /**
- * Loads pStat with all the entries only if pStats == nullptr
+ * Returns the bucket for the given absolute index, recycling the slot
+ * if it holds a bucket that already fell out of the window
+ */
+TimeWindowStats::Bucket& TimeWindowStats::getBucket(long index) {
+    Bucket& bucket = buckets[index % (long) buckets.size()];
+    if (bucket.index != index) {
+        bucket = Bucket { index, 0, 0, 0, 0 };
+    }
+    return bucket;
+}
+
+void TimeWindowStats::accrueAboveZeroTime(Timestamp now) {
+    if (lastValue > 0) {
+        long currentIndex = getBucketIndex(now);
+
+        // there is no point in going back further than the oldest bucket in the window
+        long oldestIndex = currentIndex - (long) buckets.size() + 1;
+        long index = max(getBucketIndex(lastValueTime), oldestIndex);
+        double start = max(asSeconds(lastValueTime), oldestIndex * bucketWidth);
+        double end = asSeconds(now);
+
+        /*
+         * the index is stepped instead of derived from start, because
+         * (index + 1) * bucketWidth / bucketWidth can round down to index,
+         * and the current bucket takes the rest so that the loop always ends
+         */
+        for (; start < end; index++) {
+            double bucketEnd = (index >= currentIndex) ? end : min(end, (index + 1) * bucketWidth);
+            if (bucketEnd > start) {
+                getBucket(index).aboveZeroTime += bucketEnd - start;
+                start = bucketEnd;
+            }
+        }
+    }
+    lastValueTime = now;
+}
+
+/**
+ * Merges the buckets in the window (Chan et al. parallel algorithm)
  *
- * pStats is reset to nullptr every time the list of valid entries changes
+ * This is O(buckets), which is a constant bounded by configuration
  */
-void TimeWindowStats::loadStats() {
-    if (pStats == nullptr) {
-        pStats.reset(new Stats);
-        for (const auto& entry : entries) {
-            pStats->operator ()(entry.value);
+TimeWindowStats::Bucket TimeWindowStats::mergeBuckets(Timestamp now) const {
+    long currentIndex = getBucketIndex(now);
+    Bucket merged { currentIndex, 0, 0, 0, 0 };
+    for (const auto& bucket : buckets) {
+        if (isBucketLive(bucket, currentIndex)) {
+            merged.aboveZeroTime += bucket.aboveZeroTime;
+            if (bucket.count > 0) {
+                unsigned total = merged.count + bucket.count;
+                double delta = bucket.mean - merged.mean;
+                merged.mean += delta * bucket.count / total;
+                merged.m2 += bucket.m2 + delta * delta * merged.count * bucket.count / total;
+                merged.count = total;
+            }
         }
     }
+    return merged;
 }
 
-double TimeWindowStats::getAverage() {
-    removeOldEntries();
-    double avg = 0.0;
+double TimeWindowStats::getBucketedSpan(Timestamp now) const {
+    double oldestBucketStart = (getBucketIndex(now) - (long) buckets.size() + 1) * bucketWidth;
+
+    // TODO this works only for OMNeT++
+    return min(asSeconds(now) - oldestBucketStart, omnetpp::simTime().dbl());
+}
+
+/**
+ * Appends an entry to the ring buffer and adds it to the running statistics
+ */
+void TimeWindowStats::pushEntry(const Entry& entry) {
+    if (count == entries.size()) {
 
-    if (entries.size() > 0) {
-        loadStats();
-        avg = boost::accumulators::mean(*pStats);
+        /* full (or not allocated yet): double the capacity, unwrapping the ring */
+        std::vector<Entry> grown(max(entries.size() * 2, size_t(64)));
+        for (size_t i = 0; i < count; i++) {
+            grown[i] = getEntry(i);
+        }
+        entries.swap(grown);
+        head = 0;
     }
+    entries[(head + count) & (entries.size() - 1)] = entry;
+    count++;
 
-    return avg;
+    double delta = entry.value - mean;
+    mean += delta / count;
+    m2 += delta * (entry.value - mean);
 }
 
-double TimeWindowStats::getVariance() {
-    removeOldEntries();
-    double variance = 0.0;
+/**
+ * Removes the oldest entry from the ring buffer and from the running statistics
+ */
+void TimeWindowStats::popEntry() {
+    double value = getEntry(0).value;
+    head = (head + 1) & (entries.size() - 1);
+    count--;
+
+    if (count == 0) {
 
-    if (entries.size() > 0) {
-        loadStats();
-        variance = boost::accumulators::moment<2>(*pStats);
+        /* start over, so that rounding errors don't accumulate forever */
+        mean = 0;
+        m2 = 0;
+    } else {
+        double delta = value - mean;
+        mean -= delta / count;
+        m2 -= delta * (value - mean);
+        if (m2 < 0) {
+            m2 = 0; // can only be rounding error
+        }
     }
+}
 
-    return variance;
+double TimeWindowStats::getAverage() {
+    if (!buckets.empty()) {
+        return mergeBuckets(getTimestampNow()).mean;
+    }
+    removeOldEntries();
+    return mean;
+}
+
+double TimeWindowStats::getVariance() {
+    if (!buckets.empty()) {
+        Bucket merged = mergeBuckets(getTimestampNow());
+        return (merged.count > 0) ? merged.m2 / merged.count : 0.0;
+    }
+    removeOldEntries();
+    return (count > 0) ? m2 / count : 0.0;
 }
 
 double TimeWindowStats::getRate() {
+    if (!buckets.empty()) {
+        auto now = getTimestampNow();
+        return mergeBuckets(now).count / getBucketedSpan(now);
+    }
     removeOldEntries();
 
     // TODO this works only for OMNeT++
-    return double(entries.size()) / min(asDouble(window), omnetpp::simTime().dbl());
+    return double(count) / min(asDouble(window), omnetpp::simTime().dbl());
 }
 
 unsigned TimeWindowStats::getCount() {
+    if (!buckets.empty()) {
+        return mergeBuckets(getTimestampNow()).count;
+    }
     removeOldEntries();
-    return entries.size();
+    return count;
 }
 
 double TimeWindowStats::getPercentageAboveZero() {
+    if (!buckets.empty()) {
+
+        /* in bucketed mode, the time above 0 is integrated as values are recorded */
+        auto now = getTimestampNow();
+        accrueAboveZeroTime(now);
+        return mergeBuckets(now).aboveZeroTime / getBucketedSpan(now);
+    }
+
     removeOldEntries();
-    if (entries.empty()) {
+    if (count == 0) {
         return (lastValue > 0) ? 1.0 : 0.0;
     }
 
@@ -109,7 +240,8 @@ double TimeWindowStats::getPercentageAboveZero() {
     Duration busyTime(0);
     auto lastBusyPeriodStart = windowStart; // assume this for now
     double level = -1.0;
-    for (const auto& entry : entries) {
+    for (size_t i = 0; i < count; i++) {
+        const auto& entry = getEntry(i);
         if (level < 0 && entry.value == 0) { // busy period ends
 
             /*
@@ -135,15 +267,8 @@ double TimeWindowStats::getPercentageAboveZero() {
 }
 
 void TimeWindowStats::removeOldEntries() {
-    bool entriesRemoved = false;
     auto windowStart = getTimestampNow() - window;
-    while (!entries.empty() && entries.front().timestamp < windowStart) {
-        entries.pop_front();
-        entriesRemoved = true;
-    }
-
-    if (entriesRemoved) {
-        pStats.reset(nullptr);
+    while (count > 0 && getEntry(0).timestamp < windowStart) {
+        popEntry();
     }
 }
-
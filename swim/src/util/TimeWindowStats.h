@@ -16,12 +16,9 @@
 #ifndef TIMEWINDOWSTATS_H_
 #define TIMEWINDOWSTATS_H_
 
-#include <deque>
-#include <memory>
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/mean.hpp>
-#include <boost/accumulators/statistics/moment.hpp>
+#include <vector>
+#include <cstddef>
+#include <cmath>
 
 #define USE_OMNET_CLOCK 1
 
@@ -34,6 +31,10 @@
 /**
  * Computes statistics for events in a sliding time window
  *
+ * The statistics are kept as running values that are updated when an entry
+ * is recorded and when it falls out of the window, so all the queries are
+ * O(1) (amortized, since they may have to evict old entries first)
+ *
  * @note This class is not thread-safe (intended for use in OMNET++)
  */
 class TimeWindowStats {
@@ -43,8 +44,31 @@ public:
 
     virtual void reset();
     virtual void setWindow(unsigned seconds);
+
+    /**
+     * Switches between exact and bucketed (bounded-memory) mode
+     *
+     * In exact mode (the default) every entry is kept until it falls out
+     * of the window, so memory grows with rate * window.
+     * In bucketed mode the window is divided in a fixed number of buckets
+     * that only keep the count, mean and sum of squared differences of
+     * the entries recorded in them, and the time the signal was above 0.
+     * Memory is then bounded by the number of buckets, but the window
+     * slides one whole bucket at a time, so the statistics cover the last
+     * (buckets - 1) complete buckets plus the current partial one, i.e.,
+     * between (buckets - 1) / buckets of the window and the full window.
+     *
+     * This resets the statistics, so it should be called before recording.
+     *
+     * @param buckets number of buckets, or 0 for exact mode
+     */
+    virtual void setBuckets(unsigned buckets);
     virtual void record(double value);
     virtual double getAverage();
+
+    /**
+     * Returns the (population) variance of the entries in the window
+     */
     virtual double getVariance();
 
     /**
@@ -62,13 +86,6 @@ public:
     virtual double getPercentageAboveZero();
 
 protected:
-    typedef boost::accumulators::accumulator_set<double,
-            boost::accumulators::stats<boost::accumulators::tag::mean,
-                    boost::accumulators::tag::moment<2> > > Stats;
-    std::unique_ptr<Stats> pStats;
-
-    void loadStats();
-
 #if USE_OMNET_CLOCK
     using Duration = omnetpp::simtime_t;
     using Timestamp = omnetpp::simtime_t;
@@ -88,11 +105,73 @@ protected:
         double value;
     };
 
-    std::deque<Entry> entries;
+    /**
+     * Ring buffer with the entries in the window, oldest first starting
+     * at head. Its capacity is always a power of 2 so that indices can be
+     * wrapped with a mask, and it only grows (doubling), so once it has
+     * reached the steady state size for the arrival rate there are no
+     * more allocations
+     */
+    std::vector<Entry> entries;
+    size_t head = 0;
+    size_t count = 0;
+
+    /* running statistics of the entries in the window (Welford's method) */
+    double mean = 0;
+    double m2 = 0; /**< sum of squared differences from the mean */
 
-    const unsigned ENTRIES_BETWEEN_CHECKS = 2000;
     double lastValue = 0; /**< keeps the last value even if it falls out of the window */
 
+    struct Bucket {
+        long index; /**< absolute bucket number (bucket start / bucket width) */
+        unsigned count;
+        double mean;
+        double m2;
+        double aboveZeroTime; /**< time in this bucket with the signal above 0 */
+    };
+
+    /**
+     * Buckets for the bucketed mode (empty in exact mode), used as a
+     * ring indexed by the absolute bucket number modulo the size
+     */
+    std::vector<Bucket> buckets;
+    double bucketWidth = 0; /**< in seconds */
+    Timestamp lastValueTime; /**< when lastValue was recorded (bucketed mode) */
+
+    inline long getBucketIndex(Timestamp t) const {
+        return (long) std::floor(asSeconds(t) / bucketWidth);
+    }
+
+    inline bool isBucketLive(const Bucket& bucket, long currentIndex) const {
+        return bucket.index <= currentIndex
+                && bucket.index > currentIndex - (long) buckets.size();
+    }
+
+    Bucket& getBucket(long index);
+
+    /**
+     * Adds the time the signal has been above 0 since lastValueTime to
+     * the buckets it spans
+     */
+    void accrueAboveZeroTime(Timestamp now);
+
+    /**
+     * Merges the statistics of the buckets that are in the window
+     */
+    Bucket mergeBuckets(Timestamp now) const;
+
+    /**
+     * Time covered by the buckets that are in the window
+     */
+    double getBucketedSpan(Timestamp now) const;
+
+    inline const Entry& getEntry(size_t i) const {
+        return entries[(head + i) & (entries.size() - 1)];
+    }
+
+    void pushEntry(const Entry& entry);
+    void popEntry();
+
     /**
      * Removes the entries that fell out of the time window
      */
@@ -114,6 +193,10 @@ protected:
     inline double asDouble(Duration t) const {
         return t.dbl();
     }
+
+    inline double asSeconds(Timestamp t) const {
+        return t.dbl();
+    }
 #else
     inline Timestamp getTimestampNow() const {
         return clock::now();
@@ -122,6 +205,10 @@ protected:
     inline double asDouble(Duration t) const {
         return std::chrono::duration<double>(t).count();
     }
+
+    inline double asSeconds(Timestamp t) const {
+        return asDouble(t.time_since_epoch());
+    }
 #endif
 
 };
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#include "ServerPool.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+ServerPool::ServerPool(const std::vector<ServerParams>& serverParams, double arrivalRate, unsigned seed)
+    : generator(seed), interArrival(arrivalRate), uniform(0, 1), now(0), window(60), dimmer(1),
+      nextArrival(0), rrCounter(0), requestsTotal(0) {
+    for (const ServerParams& params : serverParams) {
+        Server server;
+        server.params = params;
+        servers.push_back(server);
+    }
+    nextArrival = interArrival(generator);
+}
+
+void ServerPool::advance(double time) {
+    if (time < now) {
+        return;
+    }
+    now = time;
+
+    while (nextArrival <= now) {
+        route(nextArrival);
+        nextArrival += interArrival(generator);
+    }
+
+    while (!pending.empty() && pending.top().time <= now) {
+        completed.push_back(pending.top());
+        pending.pop();
+    }
+
+    // forget what happened before the window
+    double windowStart = getWindowStart();
+    while (!arrivals.empty() && arrivals.front() < windowStart) {
+        arrivals.pop_front();
+    }
+    while (!completed.empty() && completed.front().time < windowStart) {
+        completed.pop_front();
+    }
+    for (Server& server : servers) {
+        while (!server.busyPeriods.empty() && server.busyPeriods.front().second < windowStart) {
+            server.busyPeriods.pop_front();
+        }
+    }
+}
+
+void ServerPool::route(double arrivalTime) {
+    requestsTotal++;
+    arrivals.push_back(arrivalTime);
+
+    // round robin among the enabled servers, like HAProxy
+    Server* server = nullptr;
+    for (unsigned i = 0; i < servers.size() && !server; i++) {
+        rrCounter = (rrCounter + 1) % servers.size();
+        if (servers[rrCounter].enabled) {
+            server = &servers[rrCounter];
+        }
+    }
+    if (!server) {
+        return; // no server to take it
+    }
+
+    Completion completion;
+    completion.optional = uniform(generator) < dimmer;
+    double meanServiceTime = completion.optional ? server->params.serviceTime : server->params.lowFidelityServiceTime;
+    double serviceTime = exponential_distribution<double>(1 / meanServiceTime)(generator);
+
+    double start = max(arrivalTime, server->busyUntil);
+    server->busyUntil = start + serviceTime;
+    if (!server->busyPeriods.empty() && server->busyPeriods.back().second == start) {
+        server->busyPeriods.back().second = server->busyUntil;
+    } else {
+        server->busyPeriods.push_back(make_pair(start, server->busyUntil));
+    }
+
+    completion.time = server->busyUntil;
+    completion.responseTime = completion.time - arrivalTime;
+    pending.push(completion);
+}
+
+bool ServerPool::setEnabled(int serverNumber, bool enabled) {
+    if (serverNumber < 1 || serverNumber > (int) servers.size()) {
+        return false;
+    }
+
+    // a disabled server finishes the requests it already has
+    servers[serverNumber - 1].enabled = enabled;
+    return true;
+}
+
+bool ServerPool::isEnabled(int serverNumber) const {
+    return serverNumber >= 1 && serverNumber <= (int) servers.size() && servers[serverNumber - 1].enabled;
+}
+
+void ServerPool::setDimmer(double dimmer) {
+    this->dimmer = min(1.0, max(0.0, dimmer));
+}
+
+void ServerPool::setWindow(double window) {
+    if (window > 0) {
+        this->window = window;
+    }
+}
+
+double ServerPool::getWindowStart() const {
+    return now - window;
+}
+
+double ServerPool::getMeasuredTime() const {
+    return min(window, now);
+}
+
+std::string ServerPool::getStats() const {
+    double measuredTime = getMeasuredTime();
+    double count[2] = {0, 0};
+    double totalResponseTime[2] = {0, 0};
+    for (const Completion& completion : completed) {
+        count[completion.optional]++;
+        totalResponseTime[completion.optional] += completion.responseTime;
+    }
+
+    ostringstream stats;
+    stats << ((measuredTime > 0) ? arrivals.size() / measuredTime : 0) << ",2";
+    for (int optional = 0; optional < 2; optional++) {
+        stats << ',' << ((measuredTime > 0) ? count[optional] / measuredTime : 0);
+        stats << ',' << ((count[optional] > 0) ? 1000 * totalResponseTime[optional] / count[optional] : 0);
+    }
+    return stats.str();
+}
+
+std::string ServerPool::getUtilization() const {
+    double measuredTime = getMeasuredTime();
+    double windowStart = getWindowStart();
+
+    ostringstream utilization;
+    for (unsigned i = 0; i < servers.size(); i++) {
+
+        // only the part of the busy periods that is in the window up to now
+        double busyTime = 0;
+        for (const pair<double, double>& period : servers[i].busyPeriods) {
+            double start = max(period.first, windowStart);
+            double end = min(period.second, now);
+            if (end > start) {
+                busyTime += end - start;
+            }
+        }
+        if (i > 0) {
+            utilization << ',';
+        }
+        utilization << ((measuredTime > 0) ? 100 * busyTime / measuredTime : 0);
+    }
+    return utilization.str();
+}
@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+#ifndef SERVERPOOL_H_
+#define SERVERPOOL_H_
+
+#include <deque>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Simulated pool of servers behind a load balancer, standing in for the
+ * servers behind HAProxy
+ *
+ * Requests arrive as a Poisson process, and are sent round robin to the
+ * enabled servers, or dropped if there are none. Each server serves its
+ * requests one at a time in FIFO order, with exponential service times.
+ * A request is optional with probability equal to the dimmer.
+ *
+ * The pool is simulated lazily in real time: advance() must be called
+ * with the current time before reading the measurements or changing
+ * the pool, so that the requests that arrived before the change are not
+ * affected by it
+ */
+class ServerPool {
+public:
+    struct ServerParams {
+        double serviceTime; /**< mean service time of optional requests */
+        double lowFidelityServiceTime; /**< mean service time of basic requests */
+    };
+
+    /**
+     * @param servers parameters of each server, which are numbered from 1
+     * @param arrivalRate requests per second
+     */
+    ServerPool(const std::vector<ServerParams>& servers, double arrivalRate, unsigned seed);
+
+    /**
+     * Simulates the pool up to time now, in seconds since the start
+     */
+    void advance(double now);
+
+    /**
+     * @return false if there is no such server
+     */
+    bool setEnabled(int serverNumber, bool enabled);
+    bool isEnabled(int serverNumber) const;
+    unsigned getNumberOfServers() const { return servers.size(); }
+
+    void setDimmer(double dimmer);
+    double getDimmer() const { return dimmer; }
+
+    /**
+     * @param window seconds over which measurements are taken
+     */
+    void setWindow(double window);
+
+    /**
+     * @return arrivalRate,2,basicThroughput,basicResponseTime,optThroughput,optResponseTime
+     *   with response times in msec, as LogFileProbe reports them
+     */
+    std::string getStats() const;
+
+    /**
+     * @return the utilization (%) of each server, comma separated
+     */
+    std::string getUtilization() const;
+
+    /**
+     * @return total number of requests received
+     */
+    long long getRequestsTotal() const { return requestsTotal; }
+
+private:
+    struct Server {
+        ServerParams params;
+        bool enabled = true;
+        double busyUntil = 0;
+        std::deque<std::pair<double, double>> busyPeriods; /**< [start, end) of each busy period */
+    };
+
+    struct Completion {
+        double time;
+        double responseTime;
+        bool optional;
+        bool operator>(const Completion& other) const { return time > other.time; }
+    };
+
+    std::vector<Server> servers;
+    std::mt19937 generator;
+    std::exponential_distribution<double> interArrival;
+    std::uniform_real_distribution<double> uniform;
+    double now;
+    double window;
+    double dimmer;
+    double nextArrival;
+    unsigned rrCounter;
+    long long requestsTotal;
+
+    /** completions of the requests in service or queued, the earliest first */
+    std::priority_queue<Completion, std::vector<Completion>, std::greater<Completion>> pending;
+
+    std::deque<double> arrivals; /**< arrival times in the window */
+    std::deque<Completion> completed; /**< completions in the window, in time order */
+
+    void route(double arrivalTime);
+    double getWindowStart() const;
+
+    /**
+     * @return seconds over which the measurements are averaged, which is
+     *   shorter than the window at the start
+     */
+    double getMeasuredTime() const;
+};
+
+#endif /* SERVERPOOL_H_ */
@@ -0,0 +1,442 @@
+/*******************************************************************************
+ * Simulator of Web Infrastructure and Management
+ * Copyright (c) 2016 Carnegie Mellon University.
+ * All Rights Reserved.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS," WITH NO WARRANTIES WHATSOEVER. CARNEGIE
+ * MELLON UNIVERSITY EXPRESSLY DISCLAIMS TO THE FULLEST EXTENT PERMITTED BY LAW
+ * ALL EXPRESS, IMPLIED, AND STATUTORY WARRANTIES, INCLUDING, WITHOUT
+ * LIMITATION, THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE, AND NON-INFRINGEMENT OF PROPRIETARY RIGHTS.
+ *
+ * Released under a BSD license, please see license.txt for full terms.
+ * DM-0003883
+ *******************************************************************************/
+
+/*
+ * Stand-in for HAProxy and LogFileProbe, backed by a simulated server
+ * pool, so that the real-system path of SWIM (ExecutionManagerHAProxy and
+ * HAProxyProbe) can be run without them
+ *
+ * It serves the subset of the HAProxy admin socket commands that SWIM
+ * uses on a UNIX socket, and the LogFileProbe protocol on a TCP port
+ */
+#include "ServerPool.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+const char* DEFAULT_SOCKET_PATH = "/tmp/haproxy.sock";
+const int DEFAULT_PROBE_PORT = 5127;
+const char* BACKEND = "servers";
+const char* FRONTEND = "http-in";
+const char* PROMPT = "> ";
+
+// columns of the HAProxy stats CSV up to req_tot, which is the one SWIM reads
+const char* STAT_HEADER = "# pxname,svname,qcur,qmax,scur,smax,slim,stot,bin,bout,dreq,dresp,"
+        "ereq,econ,eresp,wretr,wredis,status,weight,act,bck,chkfail,chkdown,lastchg,"
+        "downtime,qlimit,pid,iid,sid,throttle,lbtot,tracked,type,rate,rate_lim,rate_max,"
+        "check_status,check_code,check_duration,hrsp_1xx,hrsp_2xx,hrsp_3xx,hrsp_4xx,"
+        "hrsp_5xx,hrsp_other,hanafail,req_rate,req_rate_max,req_tot,";
+const int STAT_COLUMNS = 49;
+const int STATUS_COLUMN = 17;
+const int TYPE_COLUMN = 32;
+const int REQ_TOT_COLUMN = 48;
+
+enum ClientType { ADMIN, PROBE };
+
+struct Client {
+    int fd;
+    ClientType type;
+    bool interactive;
+    string input;
+};
+
+volatile sig_atomic_t stopping = 0;
+
+void stop(int) {
+    stopping = 1;
+}
+
+chrono::steady_clock::time_point startTime;
+
+double getTime() {
+    return chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+}
+
+bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.length()) {
+        ssize_t n = send(fd, data.data() + sent, data.length() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+vector<string> split(const string& line) {
+    vector<string> words;
+    istringstream stream(line);
+    string word;
+    while (stream >> word) {
+        words.push_back(word);
+    }
+    return words;
+}
+
+/**
+ * @return the server number of <backend>/#<number> or <backend>/server<number>, 0 if invalid
+ */
+int parseServer(const string& name) {
+    string prefix = string(BACKEND) + '/';
+    if (name.compare(0, prefix.length(), prefix) != 0) {
+        return 0;
+    }
+    string server = name.substr(prefix.length());
+    if (server.compare(0, 1, "#") == 0) {
+        server.erase(0, 1);
+    } else if (server.compare(0, 6, "server") == 0) {
+        server.erase(0, 6);
+    }
+    return atoi(server.c_str());
+}
+
+string statLine(const vector<pair<int, string>>& values) {
+    vector<string> columns(STAT_COLUMNS);
+    for (const pair<int, string>& value : values) {
+        columns[value.first] = value.second;
+    }
+    string line;
+    for (const string& column : columns) {
+        line += column;
+        line += ',';
+    }
+    return line + '\n';
+}
+
+/**
+ * @param args proxy id, type mask (1 frontends, 2 backends, 4 servers) and server id
+ */
+string showStat(const ServerPool& pool, const vector<string>& args) {
+    int typeMask = (args.size() >= 4) ? atoi(args[3].c_str()) : 7;
+    if (typeMask < 0) {
+        typeMask = 7;
+    }
+    string requestsTotal = to_string(pool.getRequestsTotal());
+
+    string reply = string(STAT_HEADER) + '\n';
+    if (typeMask & 1) {
+        reply += statLine({{0, FRONTEND}, {1, "FRONTEND"}, {STATUS_COLUMN, "OPEN"},
+            {TYPE_COLUMN, "0"}, {REQ_TOT_COLUMN, requestsTotal}});
+    }
+    if (typeMask & 4) {
+        for (unsigned server = 1; server <= pool.getNumberOfServers(); server++) {
+            reply += statLine({{0, BACKEND}, {1, "server" + to_string(server)},
+                {STATUS_COLUMN, pool.isEnabled(server) ? "UP" : "MAINT"}, {TYPE_COLUMN, "2"}});
+        }
+    }
+    if (typeMask & 2) {
+        reply += statLine({{0, BACKEND}, {1, "BACKEND"}, {STATUS_COLUMN, "UP"}, {TYPE_COLUMN, "1"}});
+    }
+    return reply;
+}
+
+/**
+ * Executes an admin socket command
+ *
+ * @return the reply, or false to close the connection
+ */
+bool executeAdminCommand(ServerPool& pool, Client& client, const string& command, string& reply) {
+    vector<string> words = split(command);
+    reply.clear();
+    if (words.empty()) {
+        return true;
+    }
+
+    pool.advance(getTime());
+    if (words[0] == "prompt") {
+        client.interactive = !client.interactive;
+    } else if (words[0] == "quit") {
+        return false;
+    } else if (words.size() >= 2 && words[0] == "show" && words[1] == "stat") {
+        reply = showStat(pool, words);
+    } else if (words.size() >= 2 && (words[0] == "enable" || words[0] == "disable") && words[1] == "server") {
+        int server = (words.size() >= 3) ? parseServer(words[2]) : 0;
+        if (words.size() < 3 || words[2].find('/') == string::npos) {
+            reply = "Require 'backend/server'.\n";
+        } else if (!pool.setEnabled(server, words[0] == "enable")) {
+            reply = "No such server.\n";
+        }
+    } else if (words.size() >= 2 && words[0] == "set" && words[1] == "map") {
+        if (words.size() != 5) {
+            reply = "'set map' expects three parameters: map identifier, key and value.\n";
+        } else if (words[3] == "1") {
+
+            // the only entry SWIM uses is the dimmer, in key 1
+            pool.setDimmer(atof(words[4].c_str()));
+        }
+    } else {
+        reply = "Unknown command.\n";
+    }
+    return true;
+}
+
+/**
+ * Executes a LogFileProbe command
+ *
+ * @return the reply, which is empty for commands that have none
+ */
+string executeProbeCommand(ServerPool& pool, const string& command) {
+    vector<string> words = split(command);
+    if (words.empty()) {
+        return "";
+    }
+
+    pool.advance(getTime());
+    if (words[0] == "window" && words.size() == 2) {
+        pool.setWindow(atof(words[1].c_str()));
+        return "";
+    } else if (words[0] == "stats") {
+        return pool.getStats() + '\n';
+    } else if (words[0] == "util") {
+        return pool.getUtilization() + '\n';
+    } else if (words[0] == "time") {
+        return to_string((long) time(nullptr)) + '\n';
+    }
+    return "error: unknown command\n";
+}
+
+/**
+ * Processes the complete lines received from a client
+ *
+ * @return false if the connection must be closed
+ */
+bool processInput(ServerPool& pool, Client& client) {
+    size_t end;
+    while ((end = client.input.find('\n')) != string::npos) {
+        string line = client.input.substr(0, end);
+        client.input.erase(0, end + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (client.type == PROBE) {
+            if (!sendAll(client.fd, executeProbeCommand(pool, line))) {
+                return false;
+            }
+            continue;
+        }
+
+        // in non-interactive mode, several commands can be sent in one line separated by ';'
+        string reply;
+        string commandReply;
+        bool wasInteractive = client.interactive;
+        bool open = true;
+        size_t start = 0;
+        while (open && start <= line.length()) {
+            size_t separator = line.find(';', start);
+            if (separator == string::npos) {
+                separator = line.length();
+            }
+            open = executeAdminCommand(pool, client, line.substr(start, separator - start), commandReply);
+            reply += commandReply;
+            start = separator + 1;
+        }
+        if (!open) {
+            return false;
+        }
+        if (wasInteractive || client.interactive) {
+
+            // like HAProxy, an empty line ends each reply, except when entering interactive mode
+            if (wasInteractive) {
+                reply += '\n';
+            }
+            if (client.interactive) {
+                reply += PROMPT;
+            }
+            if (!sendAll(client.fd, reply)) {
+                return false;
+            }
+        } else {
+            sendAll(client.fd, reply);
+            return false;
+        }
+    }
+    return true;
+}
+
+int listenUnix(const char* path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    unlink(path);
+    if (fd < 0 || bind(fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+int listenTcp(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (fd < 0 || bind(fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        perror("probe port");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+vector<double> parseList(const char* list) {
+    vector<double> values;
+    istringstream stream(list);
+    string value;
+    while (getline(stream, value, ',')) {
+        values.push_back(atof(value.c_str()));
+    }
+    return values;
+}
+
+void usage(const char* program) {
+    cout << "usage: " << program << " [options]" << endl
+         << "  -n servers          number of servers (default 3)" << endl
+         << "  -s time[,time...]   mean service time of optional requests, one for all or one per server (default 0.03)" << endl
+         << "  -l time[,time...]   mean service time of basic requests, one for all or one per server (default 0.001)" << endl
+         << "  -r rate             requests per second (default 20)" << endl
+         << "  -a path             admin socket path (default " << DEFAULT_SOCKET_PATH << ")" << endl
+         << "  -p port             LogFileProbe port (default " << DEFAULT_PROBE_PORT << ")" << endl
+         << "  -d seed             random seed (default 1)" << endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    unsigned numberOfServers = 3;
+    vector<double> serviceTimes = {0.03};
+    vector<double> lowFidelityServiceTimes = {0.001};
+    double arrivalRate = 20;
+    const char* socketPath = DEFAULT_SOCKET_PATH;
+    int probePort = DEFAULT_PROBE_PORT;
+    unsigned seed = 1;
+
+    int option;
+    while ((option = getopt(argc, argv, "n:s:l:r:a:p:d:h")) != -1) {
+        switch (option) {
+        case 'n': numberOfServers = atoi(optarg); break;
+        case 's': serviceTimes = parseList(optarg); break;
+        case 'l': lowFidelityServiceTimes = parseList(optarg); break;
+        case 'r': arrivalRate = atof(optarg); break;
+        case 'a': socketPath = optarg; break;
+        case 'p': probePort = atoi(optarg); break;
+        case 'd': seed = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return (option == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    for (vector<double>* times : {&serviceTimes, &lowFidelityServiceTimes}) {
+        if (times->size() == 1) {
+            times->resize(numberOfServers, times->front());
+        }
+        if (times->size() != numberOfServers || numberOfServers == 0 || arrivalRate <= 0) {
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    vector<ServerPool::ServerParams> serverParams(numberOfServers);
+    for (unsigned i = 0; i < numberOfServers; i++) {
+        serverParams[i].serviceTime = serviceTimes[i];
+        serverParams[i].lowFidelityServiceTime = lowFidelityServiceTimes[i];
+    }
+    ServerPool pool(serverParams, arrivalRate, seed);
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+    signal(SIGPIPE, SIG_IGN);
+
+    int adminFd = listenUnix(socketPath);
+    int probeFd = listenTcp(probePort);
+    startTime = chrono::steady_clock::now();
+    cout << "Serving admin socket " << socketPath << " and LogFileProbe port " << probePort
+         << " with " << numberOfServers << " servers" << endl;
+
+    vector<Client> clients;
+    vector<struct pollfd> pollFds;
+    while (!stopping) {
+        pollFds.clear();
+        pollFds.push_back({adminFd, POLLIN, 0});
+        pollFds.push_back({probeFd, POLLIN, 0});
+        for (const Client& client : clients) {
+            pollFds.push_back({client.fd, POLLIN, 0});
+        }
+        if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+            continue; // interrupted by a signal
+        }
+
+        // clients first, because accepting changes the client list
+        for (unsigned i = clients.size(); i-- > 0;) {
+            if (!pollFds[i + 2].revents) {
+                continue;
+            }
+            Client& client = clients[i];
+            char buffer[4096];
+            ssize_t n = read(client.fd, buffer, sizeof(buffer));
+            bool open = (n > 0);
+            if (open) {
+                client.input.append(buffer, n);
+                open = processInput(pool, client);
+            }
+            if (!open) {
+                close(client.fd);
+                clients.erase(clients.begin() + i);
+            }
+        }
+        for (int listenIndex = 0; listenIndex < 2; listenIndex++) {
+            if (pollFds[listenIndex].revents & POLLIN) {
+                int fd = accept(pollFds[listenIndex].fd, nullptr, nullptr);
+                if (fd >= 0) {
+                    clients.push_back({fd, (listenIndex == 0) ? ADMIN : PROBE, false, ""});
+                }
+            }
+        }
+    }
+
+    for (const Client& client : clients) {
+        close(client.fd);
+    }
+    close(adminFd);
+    close(probeFd);
+    unlink(socketPath);
+    return EXIT_SUCCESS;
+}